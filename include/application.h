@@ -1,8 +1,13 @@
 #pragma once
 
 #include <debug_draw.h>
+#include <gpu_profiler.h>
+#include <frame_recorder.h>
+#include <tile_farm.h>
+#include <pipeline_state.h>
 #include <stdint.h>
 #include <array>
+#include <memory>
 #include <string>
 #ifdef __EMSCRIPTEN__
 #define GLFW_INCLUDE_ES3
@@ -37,6 +42,22 @@ namespace dw
 		int width = 800;
 		int height = 600;
 		std::string title = "dwSampleFramwork";
+		// Render offscreen without a visible window. Can also be enabled with '--headless'. For machines without a display,
+		// build with USE_OSMESA so GLFW creates its context through OSMesa (e.g. Mesa llvmpipe).
+		bool headless = false;
+		// Exit after this many frames, 0 runs until exit is requested. Can also be set with '--frames <count>'.
+		uint32_t max_frames = 0;
+		// Record every frame to this path: a single Y4M stream if it ends in '.y4m', otherwise <path>_<frame>.png files.
+		// Can also be set with '--record <path>'. Empty disables recording.
+		std::string record_path;
+		// Run this many headless worker processes instead (see TileFarm). Can also be set with '--farm-workers <count>'.
+		// Workers split '--frames' between them; apps doing tiled captures split the strips using farm_worker().
+		uint32_t farm_workers = 0;
+		// Index of this process within the farm, -1 if not a worker. Set by the launcher through '--farm-worker <index>'.
+		int32_t farm_worker = -1;
+		// Set by apps whose workers request exit themselves once their share is done (e.g. tiled captures). Otherwise a
+		// farm is only launched with '--frames', since workers would never exit.
+		bool farm_exits_itself = false;
 	};
 
 
@@ -90,6 +111,28 @@ namespace dw
         virtual void update(double delta);
         virtual void shutdown();
 
+		// Binds the framebuffer the application presents: the window's default framebuffer, or the internal framebuffer
+		// when running headless.
+		void bind_default_framebuffer();
+
+		// Internal framebuffer rendered into when headless, nullptr otherwise.
+		inline Framebuffer* default_framebuffer() { return m_headless_fbo.get(); }
+		inline bool			headless()			  { return m_headless; }
+
+		// Number of frames completed. Starts at the first frame of this worker's range when running in a farm.
+		inline uint32_t frame_index()	{ return m_frame_count; }
+
+		// Time in seconds at the start of the current frame. When recording or running as a farm worker, deltas are a
+		// fixed 1 / refresh rate and this is frame_index() times that, so a worker starting mid-sequence sees the same
+		// time a single run would. Animation must be driven from this rather than by accumulating deltas for farm
+		// output to form one continuous sequence.
+		inline double frame_time() { return m_fixed_delta > 0.0 ? m_frame_count * m_fixed_delta / 1000.0 : m_time; }
+		inline int32_t	farm_worker()	{ return m_farm_worker; }
+		inline uint32_t farm_workers()	{ return m_farm_workers; }
+
+		// Called in the farm launcher once every worker has finished, to merge the part files. Runs without a context.
+		virtual bool farm_merge(uint32_t worker_count);
+
 	private:
 		// Pre, Post frame methods for ImGUI updates, presentations etc.
 		void begin_frame();
@@ -99,6 +142,9 @@ namespace dw
 		bool init_base(int argc, const char* argv[]);
 		void update_base(double delta);
 		void shutdown_base();
+		bool create_headless_framebuffer();
+		void parse_arguments(int argc, const char* argv[], AppSettings& settings);
+		int run_farm(int argc, const char* argv[], const AppSettings& settings);
         
     protected:
         uint32_t                            m_width;
@@ -111,12 +157,27 @@ namespace dw
         double                              m_mouse_delta_y;
         double                              m_delta;
 		double                              m_delta_seconds;
+		double								m_fixed_delta;
+		double								m_time;
         std::string                         m_title;
         std::array<bool, MAX_KEYS>          m_keys;
         std::array<bool, MAX_MOUSE_BUTTONS> m_mouse_buttons;
         GLFWwindow*                         m_window;
         Timer                               m_timer;
+		PipelineStateBinder					m_pipeline_state_binder;
 		DebugDraw							m_debug_draw;
+#if !defined(__EMSCRIPTEN__)
+		GPUProfiler							m_gpu_profiler;
+		FrameRecorder						m_frame_recorder;
+#endif
+		bool								m_headless;
+		uint32_t							m_max_frames;
+		uint32_t							m_frame_count;
+		int32_t								m_farm_worker;
+		uint32_t							m_farm_workers;
+		std::unique_ptr<Texture2D>			m_headless_color;
+		std::unique_ptr<Texture2D>			m_headless_depth;
+		std::unique_ptr<Framebuffer>		m_headless_fbo;
     };
 }
 
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <functional>
+#include <geometry.h>
+
+#define BVH_NULL 0xFFFFFFFF
+// Number of centroid bins evaluated per axis when building with the surface area heuristic.
+#define BVH_SAH_BINS 16
+
+namespace dw
+{
+	// Dynamic bounding volume hierarchy over scene objects, e.g. world space SubMesh extents of mesh instances.
+	//
+	// build() creates a binned SAH tree in depth-first order, so the left child of every inner node immediately follows
+	// it and traversal walks memory mostly forward. Objects can then be inserted, removed and moved incrementally; moved
+	// objects only refit their ancestors. Rebuild once incremental changes have degraded the tree.
+	//
+	// Object ids returned by insert() stay valid until the object is removed, including across rebuilds.
+	class BVH
+	{
+	public:
+		// Called for each hit object with the entry distance along the ray. Returns the new maximum distance, e.g. the
+		// distance of an exact hit to only visit closer objects, or the current maximum to collect every hit.
+		using RayCallback = std::function<float(uint32_t object, float t, float t_max)>;
+
+		BVH();
+		~BVH();
+
+		uint32_t insert(const AABB& aabb, void* user_data = nullptr);
+		void	 remove(uint32_t object);
+
+		// Moves an object, refitting its ancestors.
+		void update(uint32_t object, const AABB& aabb);
+
+		// Rebuilds the tree from scratch over the current objects.
+		void build();
+
+		// Recomputes every inner node bound bottom-up. Cheaper than calling update() on many objects.
+		void refit();
+
+		// Appends the objects whose bounds intersect the frustum. Subtrees fully inside are added without further tests,
+		// and children only test the planes their parent straddles.
+		void query(const Frustum& frustum, std::vector<uint32_t>& objects);
+
+		// Visits the objects whose bounds the ray hits within 't_max', nearest subtree first.
+		void raycast(const glm::vec3& origin, const glm::vec3& direction, float t_max, RayCallback callback);
+
+		void clear();
+
+		inline const AABB& aabb(uint32_t object)	  { return m_objects[object].aabb; }
+		inline void*	   user_data(uint32_t object) { return m_objects[object].user_data; }
+		inline uint32_t	   object_count()			  { return m_object_count; }
+		inline uint32_t	   node_count()				  { return uint32_t(m_nodes.size() - m_free_nodes.size()); }
+
+	private:
+		struct Node
+		{
+			AABB	 aabb;
+			uint32_t parent;
+			uint32_t left;
+			uint32_t right;
+			uint32_t object; // BVH_NULL for inner nodes.
+		};
+
+		struct Object
+		{
+			AABB	 aabb;
+			void*	 user_data;
+			uint32_t leaf; // BVH_NULL for free slots.
+		};
+
+		uint32_t allocate_node();
+		void	 free_node(uint32_t node);
+		void	 insert_leaf(uint32_t leaf);
+		void	 remove_leaf(uint32_t leaf);
+		void	 refit_ancestors(uint32_t node);
+		uint32_t build_recursive(uint32_t* objects, uint32_t count, uint32_t parent);
+		void	 collect(uint32_t node, std::vector<uint32_t>& objects);
+
+	private:
+		std::vector<Node>	  m_nodes;
+		std::vector<uint32_t> m_free_nodes;
+		std::vector<Object>	  m_objects;
+		std::vector<uint32_t> m_free_objects;
+		std::vector<uint32_t> m_stack;
+		uint32_t			  m_root = BVH_NULL;
+		uint32_t			  m_object_count = 0;
+	};
+} // namespace dw
@@ -3,6 +3,7 @@
 #include <glm.hpp>
 #include <gtc/quaternion.hpp>
 #include <geometry.h>
+#include <stdint.h>
 
 namespace dw
 {
@@ -46,6 +47,12 @@ namespace dw
 		void update();
 		void update_projection(float fov, float near, float far, float aspect_ratio);
 		bool aabb_inside_frustum(glm::vec3 max_v, glm::vec3 min_v);
+
+		// Coherent, hierarchical variant. 'plane_mask' holds the planes left to test (FRUSTUM_PLANE_MASK_ALL for roots)
+		// and on success receives the planes the box straddles, which is the mask to pass to its children; 0 means the
+		// box is fully inside. 'last_plane' is per-object storage for the plane that last rejected it (initialize to 6
+		// or more when unknown), tested first on the next call.
+		bool aabb_inside_frustum(glm::vec3 max_v, glm::vec3 min_v, uint32_t& plane_mask, uint32_t& last_plane);
 		bool aabb_inside_plane(Plane plane, glm::vec3 max_v, glm::vec3 min_v);
 	};
 }
\ No newline at end of file
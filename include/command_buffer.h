@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <ogl.h>
+
+namespace dw
+{
+	enum CommandType
+	{
+		COMMAND_BIND_PROGRAM = 0,
+		COMMAND_BIND_VERTEX_ARRAY,
+		COMMAND_BIND_TEXTURE,
+		COMMAND_BIND_BUFFER_BASE,
+		COMMAND_BIND_BUFFER_RANGE,
+		COMMAND_BIND_FRAMEBUFFER,
+		COMMAND_UPDATE_BUFFER,
+		COMMAND_VIEWPORT,
+		COMMAND_CLEAR,
+		COMMAND_ENABLE,
+		COMMAND_DISABLE,
+		COMMAND_DEPTH_FUNC,
+		COMMAND_BLEND_FUNC,
+		COMMAND_CULL_FACE,
+		COMMAND_DRAW_ARRAYS,
+		COMMAND_DRAW_ARRAYS_INSTANCED,
+		COMMAND_DRAW_ELEMENTS_BASE_VERTEX,
+		COMMAND_DRAW_ELEMENTS_INSTANCED_BASE_VERTEX
+	};
+
+	// Records GL work without touching the context so draw preparation can run on worker threads. Commands are stored
+	// in a linear byte stream and replayed in order by execute() on the thread owning the context.
+	//
+	// Recording is not synchronized: use one CommandBuffer per thread and execute them in the desired order. Objects
+	// referenced by recorded commands must stay alive until the buffer has been executed.
+	class CommandBuffer
+	{
+	public:
+		CommandBuffer(size_t initial_capacity = 64 * 1024);
+		~CommandBuffer();
+
+		// Resource bindings.
+		void bind_program(Program* program);
+		void bind_vertex_array(VertexArray* vao);
+		void bind_texture(Texture* texture, uint32_t unit);
+		void bind_buffer_base(Buffer* buffer, uint32_t index);
+		void bind_buffer_range(Buffer* buffer, uint32_t index, size_t offset, size_t size);
+		void bind_framebuffer(Framebuffer* fbo); // nullptr binds the default framebuffer.
+
+		// Copies 'size' bytes of 'data' into the command stream. Uploaded with glBufferSubData on execution.
+		void update_buffer(Buffer* buffer, size_t offset, size_t size, const void* data);
+
+		// State changes.
+		void viewport(int32_t x, int32_t y, int32_t w, int32_t h);
+		void clear(GLbitfield mask, float r = 0.0f, float g = 0.0f, float b = 0.0f, float a = 1.0f, float depth = 1.0f);
+		void enable(GLenum cap);
+		void disable(GLenum cap);
+		void depth_func(GLenum func);
+		void blend_func(GLenum src, GLenum dst);
+		void cull_face(GLenum mode);
+
+		// Draws.
+		void draw_arrays(GLenum mode, int32_t first, int32_t count);
+		void draw_arrays_instanced(GLenum mode, int32_t first, int32_t count, int32_t instance_count);
+		void draw_elements_base_vertex(GLenum mode, int32_t count, GLenum type, size_t offset, int32_t base_vertex);
+		void draw_elements_instanced_base_vertex(GLenum mode, int32_t count, GLenum type, size_t offset, int32_t instance_count, int32_t base_vertex);
+
+		// Replays all recorded commands. Must be called on the thread owning the GL context.
+		void execute();
+
+		// Discards all recorded commands while keeping the allocated memory.
+		void reset();
+
+		inline uint32_t command_count() { return m_command_count; }
+		inline size_t	size()			{ return m_stream.size(); }
+
+	private:
+		template<typename T>
+		T* push(CommandType type, size_t payload = 0);
+
+	private:
+		std::vector<uint8_t> m_stream;
+		uint32_t m_command_count = 0;
+	};
+} // namespace dw
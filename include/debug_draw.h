@@ -6,6 +6,7 @@
 #include <vector>
 #include <memory>
 #include <ogl.h>
+#include <pipeline_state.h>
 
 // Hard-limit of vertices. Used to reserve space in vertex and draw command vectors. 
 #define MAX_VERTICES 100000
@@ -47,8 +48,10 @@ namespace dw
 	public:
 		DebugDraw();
 
-		// Initialization and shutdown.
+		// Initialization and shutdown. Render state is applied through the given binder, or an internal one if none is
+		// given.
 		bool init();
+		bool init(PipelineStateBinder* binder);
 		void shutdown();
 
 		// Debug shape drawing.
@@ -81,10 +84,13 @@ namespace dw
 
 		// GPU resources.
 		std::unique_ptr<VertexArray> m_line_vao;
-		std::unique_ptr<VertexBuffer> m_line_vbo;
+		std::unique_ptr<StreamBuffer> m_line_vbo;
 		std::unique_ptr<Shader> m_line_vs;
 		std::unique_ptr<Shader> m_line_fs;
 		std::unique_ptr<Program> m_line_program;
-		std::unique_ptr<UniformBuffer> m_ubo;
+		std::unique_ptr<StreamBuffer> m_ubo;
+		std::unique_ptr<PipelineState> m_pso;
+		PipelineStateBinder m_default_binder;
+		PipelineStateBinder* m_binder = nullptr;
 	};
 } // namespace dw
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <framebuffer_readback.h>
+
+namespace dw
+{
+#if !defined(__EMSCRIPTEN__)
+	enum FrameRecorderFormat
+	{
+		FRAME_RECORDER_FORMAT_PNG, // One PNG per frame named <path>_<frame>.png
+		FRAME_RECORDER_FORMAT_Y4M  // Single uncompressed YUV 4:2:0 stream. Much cheaper to encode than PNG.
+	};
+
+	// Records a frame sequence to disk without waiting on the GPU or the encoder. Frames are read back through a
+	// FramebufferReadback and encoded on a pool of worker threads. The job queue is bounded: when the workers fall behind,
+	// delivering the next frame blocks until a job finishes instead of buffering frames without limit.
+	class FrameRecorder
+	{
+	public:
+		FrameRecorder();
+		~FrameRecorder();
+
+		// 'num_workers' of 0 uses one worker per hardware thread. PNG files are numbered from 'first_frame'.
+		bool start(const std::string& path, FrameRecorderFormat format, uint32_t width, uint32_t height, uint32_t fps = 60, uint32_t num_workers = 0, uint32_t max_queued_frames = 8, uint64_t first_frame = 0);
+
+		// Queues a readback of color attachment 0 of 'fbo' (nullptr for the default framebuffer) and hands completed
+		// readbacks to the workers. Call once per frame after rendering. 'width' and 'height' are the framebuffer's
+		// current size (0 for the size passed to start()); after a resize only the overlap with the recorded size is
+		// read, and frames smaller than it are padded with black.
+		void capture(Framebuffer* fbo, uint32_t width = 0, uint32_t height = 0);
+
+		// Writes out every pending frame and stops the workers.
+		void stop();
+
+		inline bool		recording()		 { return m_recording; }
+		inline uint64_t frames_written() { return m_frames_written; }
+
+	private:
+		struct Job
+		{
+			uint64_t			 frame;
+			std::vector<uint8_t> pixels;
+		};
+
+		void enqueue(const void* pixels, uint32_t width, uint32_t height, uint64_t frame);
+		void worker();
+		void write_png(Job& job);
+		void write_y4m(Job& job);
+
+	private:
+		bool								 m_recording = false;
+		std::string							 m_path;
+		FrameRecorderFormat					 m_format;
+		uint32_t							 m_width;
+		uint32_t							 m_height;
+		uint32_t							 m_max_queued_frames;
+		uint64_t							 m_frames_written = 0;
+		uint64_t							 m_first_frame = 0;
+		FILE*								 m_y4m_file = nullptr;
+		std::unique_ptr<FramebufferReadback> m_readback;
+		std::vector<std::thread>			 m_workers;
+		std::deque<Job>						 m_jobs;
+		std::mutex							 m_mutex;
+		std::condition_variable				 m_job_cv;
+		std::condition_variable				 m_space_cv;
+		std::condition_variable				 m_write_cv;
+		uint64_t							 m_next_write = 0;
+		bool								 m_quit = false;
+	};
+#endif
+} // namespace dw
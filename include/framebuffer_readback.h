@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <functional>
+#include <ogl.h>
+
+namespace dw
+{
+#if !defined(__EMSCRIPTEN__)
+	// Reads framebuffers back without stalling the pipeline. Each read() issues glReadPixels into one of a ring of
+	// pixel pack buffers followed by a fence, and poll() hands the pixels of completed reads to their callback, usually
+	// 2-3 frames later. Results are always delivered in the order the reads were issued.
+	//
+	// Pixels are tightly packed rows, bottom row first, as returned by glReadPixels.
+	class FramebufferReadback
+	{
+	public:
+		using Callback = std::function<void(const void* pixels, uint32_t width, uint32_t height, uint64_t id)>;
+
+		FramebufferReadback(uint32_t num_buffers = 3);
+		~FramebufferReadback();
+
+		// Queues a read of a color attachment of 'fbo', or of the default framebuffer's back buffer if 'fbo' is nullptr.
+		// Only blocks if every buffer in the ring is still waiting on the GPU. Returns the id passed to the callback.
+		uint64_t read(Framebuffer* fbo, uint32_t attachment, int32_t x, int32_t y, uint32_t width, uint32_t height, Callback callback, GLenum format = GL_RGBA, GLenum type = GL_UNSIGNED_BYTE);
+
+		// Delivers every completed read without waiting. Call once per frame.
+		void poll();
+
+		// Waits for and delivers every pending read, e.g. before shutdown.
+		void flush();
+
+		uint32_t pending();
+
+	private:
+		struct Slot
+		{
+			GLuint	 pbo = 0;
+			size_t	 capacity = 0;
+			GLsync	 fence = nullptr;
+			uint32_t width = 0;
+			uint32_t height = 0;
+			size_t	 size = 0;
+			uint64_t id = 0;
+			Callback callback;
+		};
+
+		bool deliver(Slot& slot, bool wait);
+
+	private:
+		std::vector<Slot> m_slots;
+		uint32_t		  m_head = 0;
+		uint32_t		  m_tail = 0;
+		uint32_t		  m_pending = 0;
+		uint64_t		  m_next_id = 0;
+	};
+#endif
+} // namespace dw
@@ -1,6 +1,16 @@
 #pragma once
 
 #include <glm.hpp>
+#include <stdint.h>
+
+// Plane mask covering all six frustum planes.
+#define FRUSTUM_PLANE_MASK_ALL 0x3F
+
+// Batches smaller than this are culled on the calling thread by cull_aabbs_parallel().
+#define CULL_AABBS_MIN_BATCH_PER_THREAD 16384
+
+// Maximum number of frustums culled in one cull_aabbs_multi() sweep, one bit per frustum in the view masks.
+#define CULL_AABBS_MAX_FRUSTUMS 32
 
 namespace dw
 {
@@ -122,4 +132,70 @@ namespace dw
 
 		return true;
 	}
-}
+
+	// Hierarchical variant testing only the planes set in 'plane_mask'. On success 'plane_mask' receives the planes the
+	// box straddles, which are the only ones its children need to test; 0 means it is fully inside. On failure
+	// 'rejecting_plane' (if given) receives the plane that culled it.
+	inline bool intersects(const Frustum& frustum, const AABB& aabb, uint32_t& plane_mask, uint32_t* rejecting_plane = nullptr)
+	{
+		uint32_t child_mask = 0;
+
+		for (uint32_t i = 0; i < 6; i++)
+		{
+			if (!(plane_mask & (1 << i)))
+				continue;
+
+			const Plane& plane = frustum.planes[i];
+
+			// p-vertex: the corner furthest along the normal. If it is behind the plane the whole box is.
+			glm::vec3 p = glm::vec3(plane.n.x >= 0.0f ? aabb.max.x : aabb.min.x, plane.n.y >= 0.0f ? aabb.max.y : aabb.min.y, plane.n.z >= 0.0f ? aabb.max.z : aabb.min.z);
+
+			if (glm::dot(plane.n, p) + plane.d < 0.0f)
+			{
+				if (rejecting_plane)
+					*rejecting_plane = i;
+
+				return false;
+			}
+
+			// n-vertex: the opposite corner. If it is behind the plane the box straddles it.
+			glm::vec3 n = glm::vec3(plane.n.x >= 0.0f ? aabb.min.x : aabb.max.x, plane.n.y >= 0.0f ? aabb.min.y : aabb.max.y, plane.n.z >= 0.0f ? aabb.min.z : aabb.max.z);
+
+			if (glm::dot(plane.n, n) + plane.d < 0.0f)
+				child_mask |= 1 << i;
+		}
+
+		plane_mask = child_mask;
+
+		return true;
+	}
+
+	// Boxes in structure-of-arrays layout for batch culling. 'extent' is the half size of the box.
+	struct AABBArray
+	{
+		const float* center_x;
+		const float* center_y;
+		const float* center_z;
+		const float* extent_x;
+		const float* extent_y;
+		const float* extent_z;
+	};
+
+	// Culls boxes [first, first + count) and writes one visibility bit per box into 'visibility', bit (i % 32) of word
+	// (i / 32). 'first' must be a multiple of 32 so each call owns whole words. Uses AVX when the library is built with
+	// USE_AVX, SSE otherwise, with a scalar loop for the tail and other architectures.
+	void cull_aabbs(const Frustum& frustum, const AABBArray& boxes, uint32_t first, uint32_t count, uint32_t* visibility);
+
+	// Splits very large batches across up to 'num_threads' threads (0 uses one per hardware thread), drawn from worker
+	// threads that persist between calls. Each thread culls a range of whole visibility words.
+	void cull_aabbs_parallel(const Frustum& frustum, const AABBArray& boxes, uint32_t count, uint32_t* visibility, uint32_t num_threads = 0);
+
+	// Culls boxes [first, first + count) against up to CULL_AABBS_MAX_FRUSTUMS frustums at once, e.g. the main camera,
+	// every shadow cascade and cube map faces, and writes one mask per box into 'view_masks' with bit f set if the box
+	// intersects frustums[f]. Each box is loaded once and tested against all views, with the planes of a frustum packed
+	// into SIMD lanes, instead of streaming the boxes through memory once per view.
+	void cull_aabbs_multi(const Frustum* frustums, uint32_t frustum_count, const AABBArray& boxes, uint32_t first, uint32_t count, uint32_t* view_masks);
+
+	// Multithreaded cull_aabbs_multi() over boxes [0, count), split the same way as cull_aabbs_parallel().
+	void cull_aabbs_multi_parallel(const Frustum* frustums, uint32_t frustum_count, const AABBArray& boxes, uint32_t count, uint32_t* view_masks, uint32_t num_threads = 0);
+}
\ No newline at end of file
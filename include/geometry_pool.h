@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <ogl.h>
+
+#define GEOMETRY_POOL_INVALID_HANDLE 0xFFFFFFFF
+#define RANGE_ALLOCATOR_INVALID_OFFSET 0xFFFFFFFF
+
+namespace dw
+{
+	// Best-fit free list allocator for ranges of elements. Adjacent free ranges are coalesced on release.
+	class RangeAllocator
+	{
+	public:
+		RangeAllocator(uint32_t size);
+
+		// Returns the offset of a range of 'size' elements, or RANGE_ALLOCATOR_INVALID_OFFSET if no free range is large enough.
+		uint32_t allocate(uint32_t size);
+		void free(uint32_t offset);
+
+		// Releases all ranges and resizes the allocator.
+		void reset(uint32_t size);
+
+		uint32_t size();
+		uint32_t free_space();
+		uint32_t largest_free_range();
+
+	private:
+		void insert_free_range(uint32_t offset, uint32_t size);
+		void remove_free_range(std::map<uint32_t, uint32_t>::iterator itr);
+
+	private:
+		uint32_t m_size;
+		uint32_t m_free_space;
+		std::map<uint32_t, uint32_t> m_free_by_offset;
+		std::multimap<uint32_t, uint32_t> m_free_by_size;
+		std::unordered_map<uint32_t, uint32_t> m_allocations;
+	};
+
+	// Sub-allocates vertex and index ranges for many meshes from one large vertex buffer and one large index buffer
+	// sharing a single vertex array. Allocations are referred to by handle since defragment() may move them.
+	class GeometryPool
+	{
+	public:
+		GeometryPool(size_t vertex_size, uint32_t max_vertices, uint32_t max_indices, int attrib_count, VertexAttrib attribs[]);
+		~GeometryPool();
+
+		// Uploads the given geometry and returns a handle to it, or GEOMETRY_POOL_INVALID_HANDLE if the pool is full.
+		uint32_t allocate(uint32_t num_vertices, const void* vertices, uint32_t num_indices, const uint32_t* indices);
+		void free(uint32_t handle);
+
+		// Compacts all live allocations to the start of the buffers. Base offsets must be re-queried afterwards.
+		void defragment();
+
+		// Offsets of an allocation in elements. Use these as the base vertex and first index of draw calls.
+		uint32_t base_vertex(uint32_t handle);
+		uint32_t base_index(uint32_t handle);
+
+		inline VertexArray*	 vertex_array()	 { return m_vao.get(); }
+		inline VertexBuffer* vertex_buffer() { return m_vbo.get(); }
+		inline IndexBuffer*	 index_buffer()	 { return m_ibo.get(); }
+		inline size_t		 vertex_size()	 { return m_vertex_size; }
+
+		// Shared VertexFormat matching the pool's vertex layout.
+		VertexFormat* vertex_format();
+
+	private:
+		struct Allocation
+		{
+			uint32_t vertex_offset;
+			uint32_t vertex_count;
+			uint32_t index_offset;
+			uint32_t index_count;
+			bool	 live;
+		};
+
+		void create_vertex_array();
+
+	private:
+		size_t m_vertex_size;
+		uint32_t m_max_vertices;
+		uint32_t m_max_indices;
+		std::vector<VertexAttrib> m_attribs;
+		std::vector<Allocation> m_allocations;
+		std::vector<uint32_t> m_free_handles;
+		RangeAllocator m_vertex_allocator;
+		RangeAllocator m_index_allocator;
+
+		// GPU resources.
+		std::unique_ptr<VertexArray> m_vao;
+		std::unique_ptr<VertexBuffer> m_vbo;
+		std::unique_ptr<IndexBuffer> m_ibo;
+	};
+} // namespace dw
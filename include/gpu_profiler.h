@@ -0,0 +1,96 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <ogl.h>
+#include <macros.h>
+
+// Number of frames a scope's timestamps may stay in flight before its slot is reused.
+#define GPU_PROFILER_LATENCY 4
+// Number of resolved samples each scope keeps for min/avg/max.
+#define GPU_PROFILER_HISTORY 120
+
+namespace dw
+{
+#if !defined(__EMSCRIPTEN__)
+	// Measures GPU time of named scopes with GL_TIMESTAMP query pairs without ever waiting on the GPU.
+	//
+	// Every scope owns a ring of GPU_PROFILER_LATENCY query pairs indexed by frame. Results are polled with
+	// result_available() at the start of each frame and only read once the GPU has produced them, typically a few
+	// frames later. If the GPU falls so far behind that a slot is still pending, that frame is simply not measured.
+	class GPUProfiler
+	{
+	public:
+		struct Stats
+		{
+			double last_ms = 0.0;
+			double min_ms = 0.0;
+			double avg_ms = 0.0;
+			double max_ms = 0.0;
+		};
+
+		GPUProfiler();
+		~GPUProfiler();
+
+		// Collects available results and advances the ring. Call once at the start of every frame.
+		void begin_frame();
+
+		void begin(const std::string& name);
+		void end(const std::string& name);
+
+		// Returns false if the scope has not been resolved yet.
+		bool stats(const std::string& name, Stats& stats);
+
+		// Draws a table of every scope's timings inside the current ImGui window.
+		void ui();
+
+		// Releases all queries. Must be called while the context is still alive.
+		void shutdown();
+
+		inline void set_enabled(bool enabled) { m_enabled = enabled; }
+		inline bool enabled()				  { return m_enabled; }
+
+	private:
+		struct Scope
+		{
+			std::string			   name;
+			uint32_t			   depth = 0;
+			std::unique_ptr<Query> start[GPU_PROFILER_LATENCY];
+			std::unique_ptr<Query> end[GPU_PROFILER_LATENCY];
+			bool				   pending[GPU_PROFILER_LATENCY];
+			bool				   active = false;
+			double				   history[GPU_PROFILER_HISTORY];
+			uint32_t			   history_count = 0;
+			uint32_t			   history_head = 0;
+			Stats				   stats;
+		};
+
+		Scope* find_or_create(const std::string& name);
+		void   resolve(Scope& scope);
+
+	private:
+		bool									 m_enabled = true;
+		uint32_t								 m_frame = 0;
+		uint32_t								 m_depth = 0;
+		std::vector<std::unique_ptr<Scope>>		 m_scopes;
+		std::unordered_map<std::string, Scope*>	 m_scope_map;
+	};
+
+	// Times the enclosing block: DW_GPU_PROFILER_SCOPE(profiler, "Shadows");
+	class GPUProfilerScope
+	{
+	public:
+		GPUProfilerScope(GPUProfiler& profiler, const std::string& name) : m_profiler(profiler), m_name(name) { m_profiler.begin(m_name); }
+		~GPUProfilerScope() { m_profiler.end(m_name); }
+
+	private:
+		GPUProfiler& m_profiler;
+		std::string	 m_name;
+	};
+
+#define DW_GPU_PROFILER_SCOPE(profiler, name) dw::GPUProfilerScope DW_CONCAT(gpu_profiler_scope_, __LINE__)(profiler, name)
+#endif
+} // namespace dw
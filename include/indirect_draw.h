@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <memory>
+#include <ogl.h>
+
+namespace dw
+{
+	class Mesh;
+
+	// Layout mandated by GL_DRAW_INDIRECT_BUFFER for glMultiDrawElementsIndirect.
+	struct DrawElementsIndirectCommand
+	{
+		uint32_t count;
+		uint32_t instance_count;
+		uint32_t first_index;
+		int32_t	 base_vertex;
+		uint32_t base_instance;
+	};
+
+#if !defined(__EMSCRIPTEN__)
+	// Collects SubMesh draws sharing one vertex array (a single Mesh, or Meshes from the same GeometryPool) and submits
+	// them with a single glMultiDrawElementsIndirect call.
+	//
+	// Each draw is assigned a contiguous range of instance slots through its base instance, so per-draw data can be
+	// fetched in the shader with 'gl_BaseInstance + gl_InstanceID' or, for single-instance draws, with 'gl_DrawID'.
+	// Both built-ins need GL 4.6 (see shader_draw_parameters()). Portable shaders declare 'uniform int u_BaseInstance'
+	// and use 'u_BaseInstance + gl_InstanceID' instead. When the built-ins are unavailable and the program has that
+	// uniform, submit() sets it and issues one draw per command.
+	//
+	// Contexts older than GL 4.3 (macOS) always draw one command at a time with glDrawElementsInstancedBaseVertex,
+	// since base instance in indirect commands is reserved before GL 4.2.
+	class IndirectDrawList
+	{
+	public:
+		IndirectDrawList(uint32_t max_draws);
+		~IndirectDrawList();
+
+		// Removes all draws. Call at the start of every frame.
+		void clear();
+
+		// Appends a draw of one SubMesh. Returns the base instance assigned to it, which is also the index of its first
+		// per-draw data entry.
+		uint32_t add(Mesh* mesh, uint32_t sub_mesh, uint32_t instance_count = 1);
+
+		// Appends a draw for every SubMesh of the given Mesh.
+		void add(Mesh* mesh, uint32_t instance_count = 1);
+
+		// Uploads the command list and draws it. Binds the shared vertex array; the given program, textures and buffers
+		// must already be bound. 'program' is only needed to set 'u_BaseInstance' when shader_draw_parameters() is
+		// false. Call at most once per frame.
+		void submit(GLenum mode = GL_TRIANGLES, Program* program = nullptr);
+
+		// True if shaders can use gl_BaseInstance and gl_DrawID.
+		static bool shader_draw_parameters();
+
+		inline uint32_t						draw_count()	 { return m_commands.size(); }
+		inline uint32_t						instance_count() { return m_instance_count; }
+		inline DrawElementsIndirectCommand* commands()		 { return m_commands.data(); }
+
+	private:
+		uint32_t m_max_draws;
+		uint32_t m_instance_count = 0;
+		VertexArray* m_vao = nullptr;
+		std::vector<DrawElementsIndirectCommand> m_commands;
+		std::unique_ptr<StreamBuffer> m_buffer;
+	};
+#endif
+} // namespace dw
@@ -11,4 +11,6 @@
 #define DW_ZERO_MEMORY(x) memset(&x, 0, sizeof(x))
 
 #define DW_SAFE_DELETE(x) if(x) { delete x; x = nullptr; }
-#define DW_SAFE_DELETE_ARRAY(x) if(x) { delete[] x; x = nullptr; }
\ No newline at end of file
+#define DW_SAFE_DELETE_ARRAY(x) if(x) { delete[] x; x = nullptr; }
+#define DW_CONCAT_IMPL(a, b) a##b
+#define DW_CONCAT(a, b) DW_CONCAT_IMPL(a, b)
@@ -24,8 +24,12 @@ namespace dw
 		
 		// Rendering related getters.
 		inline Texture2D* texture(const uint32_t& index) { return m_textures[index];  }
+		inline Sampler*	  sampler(const uint32_t& index) { return m_samplers[index];  }
 		inline glm::vec4  albedo_value()				 { return m_albedo_val;	 }
 
+		// Overrides the shared default sampler used for the texture at 'index'.
+		inline void set_sampler(const uint32_t& index, Sampler* sampler) { m_samplers[index] = sampler; }
+
 	private:
 		// Private constructor and destructor.
 		Material();
@@ -44,5 +48,8 @@ namespace dw
 
 		// Texture list. In the same order as the Assimp texture enums.
 		Texture2D* m_textures[16];
+
+		// Sampler per texture slot. Shared through the Sampler cache so materials do not carry per-texture state.
+		Sampler* m_samplers[16];
 	};
 } // namespace dw
@@ -10,6 +10,7 @@
 namespace dw
 {
 	class Material;
+	class GeometryPool;
 
 	// Non-skeletal vertex structure. 
 	struct Vertex
@@ -36,21 +37,36 @@ namespace dw
 	{
 	public:
 		// Static factory methods.
-		static Mesh* load(const std::string& path, bool load_materials = true);
+		// If a GeometryPool is provided, vertex and index data are sub-allocated from it instead of dedicated buffers.
+		static Mesh* load(const std::string& path, bool load_materials = true, GeometryPool* pool = nullptr);
 		// Custom factory method for creating a mesh from provided data.
-		static Mesh* load(const std::string& name, int num_vertices, Vertex* vertices, int num_indices, uint32_t* indices, int num_sub_meshes, SubMesh* sub_meshes, glm::vec3 max_extents, glm::vec3 min_extents);
+		static Mesh* load(const std::string& name, int num_vertices, Vertex* vertices, int num_indices, uint32_t* indices, int num_sub_meshes, SubMesh* sub_meshes, glm::vec3 max_extents, glm::vec3 min_extents, GeometryPool* pool = nullptr);
 		static bool is_loaded(const std::string& name);
 		static void unload(Mesh*& mesh);
 
 		// Rendering-related getters.
-        inline VertexArray* mesh_vertex_array()	{ return m_vao.get();			 }
+        VertexArray* mesh_vertex_array();
+		VertexFormat* vertex_format();
+		Buffer* mesh_vertex_buffer();
+		IndexBuffer* mesh_index_buffer();
 		inline uint32_t sub_mesh_count()		{ return m_sub_mesh_count; }
 		inline SubMesh* sub_meshes()			{ return m_sub_meshes;	 }
 
+		// CPU copies of the geometry, kept for the lifetime of the mesh.
+		inline uint32_t vertex_count()			{ return m_vertex_count; }
+		inline uint32_t index_count()			{ return m_index_count;	 }
+		inline Vertex*	vertices()				{ return m_vertices;	 }
+		inline uint32_t* indices()				{ return m_indices;		 }
+
+		// Offsets of this mesh within its GeometryPool. Add these to the SubMesh base vertex and base index. Zero when
+		// the mesh owns its buffers.
+		uint32_t base_vertex();
+		uint32_t base_index();
+
 	private:
 		// Private constructor and destructor to prevent manual creation.
 		Mesh();
-		Mesh(const std::string& path, bool load_materials);
+		Mesh(const std::string& path, bool load_materials, GeometryPool* pool);
 		~Mesh();
 
 		// Internal initialization methods.
@@ -72,6 +88,8 @@ namespace dw
 		glm::vec3 m_min_extents;
 
 		// GPU resources.
+		GeometryPool* m_pool = nullptr;
+		uint32_t m_pool_handle;
         std::unique_ptr<VertexArray> m_vao = nullptr;
 		std::unique_ptr<VertexBuffer> m_vbo = nullptr;
 		std::unique_ptr<IndexBuffer> m_ibo = nullptr;
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <glm.hpp>
+#include <geometry.h>
+
+namespace dw
+{
+	class Mesh;
+
+	// CPU occlusion culling against a low resolution depth buffer. Designated occluders (large, simple meshes such as
+	// walls and buildings) are rasterized every frame, then object bounds are tested against the result before drawing.
+	//
+	// Rows of the buffer are split into bands rasterized in parallel on the shared WorkerPool, each band only processing
+	// the triangles binned to it. Rasterization and tests use SSE where available. Everything runs on the CPU.
+	//
+	// Usage per frame: begin_frame(camera->m_view_projection), add_occluder() for each occluder, rasterize(), then
+	// visible() for every object that passed frustum culling.
+	class OcclusionCuller
+	{
+	public:
+		// 'width' is rounded up to a multiple of 4. 'num_threads' of 0 uses one band per hardware thread.
+		OcclusionCuller(uint32_t width = 256, uint32_t height = 128, uint32_t num_threads = 0);
+		~OcclusionCuller();
+
+		// Clears the depth buffer and the occluder list.
+		void begin_frame(const glm::mat4& view_projection);
+
+		// Adds an indexed triangle list. 'positions' points at the first vertex position and 'stride' is the distance in
+		// bytes between positions. Triangles are clipped against the near plane, so only geometry the GPU would draw
+		// can occlude.
+		void add_occluder(const void* positions, size_t stride, const uint32_t* indices, uint32_t index_count, uint32_t base_vertex, const glm::mat4& model);
+
+		// Adds every SubMesh of a Mesh.
+		void add_occluder(Mesh* mesh, const glm::mat4& model);
+
+		// Rasterizes the occluders added since begin_frame().
+		void rasterize();
+
+		// Returns false if the box is hidden behind the occluders or entirely off screen. Conservative: boxes crossing
+		// the near plane are always visible.
+		bool visible(const AABB& aabb);
+
+		inline const float* depth_buffer()	 { return m_depth.data(); }
+		inline uint32_t		width()			 { return m_width; }
+		inline uint32_t		height()		 { return m_height; }
+		inline uint32_t		triangle_count() { return uint32_t(m_triangles.size()); }
+
+	private:
+		struct Triangle
+		{
+			glm::vec3 v[3]; // Screen space x and y in pixels, depth in [0, 1].
+		};
+
+		void add_triangle(const glm::vec4& c0, const glm::vec4& c1, const glm::vec4& c2);
+		void rasterize_band(uint32_t band);
+		void rasterize_triangle(const Triangle& triangle, uint32_t band_min_y, uint32_t band_max_y);
+
+	private:
+		uint32_t						   m_width;
+		uint32_t						   m_height;
+		uint32_t						   m_num_bands;
+		glm::mat4						   m_view_projection;
+		std::vector<float>				   m_depth;
+		std::vector<Triangle>			   m_triangles;
+		std::vector<std::vector<uint32_t>> m_bins;
+	};
+} // namespace dw
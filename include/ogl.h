@@ -11,6 +11,7 @@
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <memory>
 #include <glm.hpp>
 //#define DW_ENABLE_GL_ERROR_CHECK
 // OpenGL error checking macro.
@@ -50,6 +51,10 @@ err = glGetError();																				  \
 
 namespace dw
 {
+	// True on GL 4.5+ contexts. The wrappers below then use Direct State Access to create and edit objects, leaving the
+	// current bindings untouched. Queried from the version glad loaded, so it is only valid once a context exists.
+	bool dsa_supported();
+
 	// Texture base class.
     class Texture
     {
@@ -70,6 +75,7 @@ namespace dw
         // Getters.
 		GLuint id();
 		GLenum target();
+		GLenum internal_format();
 		uint32_t array_size();
         
         // Texture sampler functions.
@@ -159,6 +165,51 @@ namespace dw
 		uint32_t m_height;
 		uint32_t m_mip_levels;
     };
+
+	// Sampling state. Defaults match the parameters Texture constructors set.
+	struct SamplerDesc
+	{
+		GLenum	  min_filter = GL_LINEAR_MIPMAP_LINEAR;
+		GLenum	  mag_filter = GL_LINEAR;
+		GLenum	  wrap_s = GL_REPEAT;
+		GLenum	  wrap_t = GL_REPEAT;
+		GLenum	  wrap_r = GL_REPEAT;
+		GLenum	  compare_mode = GL_NONE;
+		GLenum	  compare_func = GL_LEQUAL;
+		float	  max_anisotropy = 1.0f;
+		glm::vec4 border_color = glm::vec4(0.0f);
+
+		bool operator==(const SamplerDesc& other) const;
+	};
+
+	struct SamplerDescHash
+	{
+		size_t operator()(const SamplerDesc& desc) const;
+	};
+
+	// GL sampler object. Bound to a texture unit it overrides the parameters of whatever texture is bound there, so
+	// the same texture can be sampled in different ways without duplicating it.
+	class Sampler
+	{
+	public:
+		// Returns the shared sampler for the given state, creating it on first use.
+		static Sampler* get(const SamplerDesc& desc);
+		// Destroys every cached sampler.
+		static void clear_cache();
+
+		Sampler(const SamplerDesc& desc);
+		~Sampler();
+		void bind(uint32_t unit);
+		void unbind(uint32_t unit);
+		GLuint id();
+		const SamplerDesc& desc();
+
+	private:
+		static std::unordered_map<SamplerDesc, std::unique_ptr<Sampler>, SamplerDescHash> m_cache;
+
+		GLuint m_gl_sampler;
+		SamplerDesc m_desc;
+	};
     
     class Framebuffer
     {
@@ -184,11 +235,18 @@ namespace dw
 		void attach_depth_stencil_target(TextureCube* texture, uint32_t face, uint32_t layer, uint32_t mip_level);
         
 		uint32_t render_targets();
+		GLuint id();
+
+		// Completeness is checked on every attach by default. Owners that attach many targets, or that know the
+		// configuration is valid, can disable it and call validate() once instead.
+		void set_validation(bool enabled);
+		bool validate();
 
     private:
-        void check_status();
+        bool check_status();
 
     private:
+		bool m_validation = true;
 		uint32_t m_render_target_count = 0;
 		GLuint m_attachments[16];
         GLuint m_gl_fbo;
@@ -205,11 +263,17 @@ namespace dw
         ~Shader();
         GLenum type();
 		bool compiled();
+
+	private:
+		// Parses '//#binding N' annotations on uniform blocks and '//#slot N' annotations on samplers.
+		void parse_annotations(const std::string& source);
         
     private:
 		bool m_compiled;
         GLuint m_gl_shader;
         GLenum m_type;
+		std::unordered_map<std::string, int> m_block_bindings;
+		std::unordered_map<std::string, int> m_sampler_slots;
     };
     
     class Program
@@ -219,6 +283,9 @@ namespace dw
         ~Program();
         void use();
 		void uniform_block_binding(std::string name, int binding);
+		// Location of an active uniform, -1 if it doesn't exist. Lets hot paths look a uniform up once and set it with
+		// glUniform* directly.
+		GLint uniform_location(const std::string& name);
 		bool set_uniform(std::string name, int value);
 		bool set_uniform(std::string name, float value);
 		bool set_uniform(std::string name, glm::vec2 value);
@@ -254,6 +321,12 @@ namespace dw
 		void* map_range(GLenum access, size_t offset, size_t size);
 		void unmap();
 		void set_data(size_t offset, size_t size, void* data);
+		GLuint id();
+		size_t size();
+
+	protected:
+		// Creates the buffer object without allocating storage. Used by derived classes that allocate storage themselves.
+		Buffer(GLenum type, size_t size);
 
 	protected:
 		GLenum m_type;
@@ -296,6 +369,66 @@ namespace dw
 	};
 #endif
 
+	// Buffer split into per-frame regions guarded by fences. Allocations are handed out linearly from the region of the
+	// current frame and written through a persistent mapping, so uploads never wait on the GPU reading earlier frames.
+	// Falls back to a staging copy and glBufferSubData when glBufferStorage is unavailable.
+	class StreamBuffer : public Buffer
+	{
+	public:
+		StreamBuffer(GLenum type, size_t size, uint32_t num_frames = 3);
+		~StreamBuffer();
+
+		// Makes the next region current, waiting only if the GPU is still reading it. Call once per frame before allocating.
+		void begin_frame();
+
+		// Fences the current region. Call once per frame after the last command reading from it has been issued.
+		void end_frame();
+
+		// Returns a write pointer to 'size' bytes within the current region. 'offset' receives the position of the
+		// allocation relative to the start of the buffer and is a multiple of 'alignment', which may take up to
+		// 'alignment' - 1 bytes of padding. Returns nullptr if the region is full.
+		void* allocate(size_t size, size_t alignment, size_t& offset);
+
+		// Makes the allocations written since the last flush visible to the GPU. No-op for persistently mapped buffers.
+		void flush();
+
+		size_t region_size();
+		bool persistent();
+
+	private:
+		bool m_persistent;
+		uint32_t m_num_frames;
+		uint32_t m_current_frame;
+		size_t m_region_size;
+		size_t m_head = 0;
+		size_t m_flushed = 0;
+		uint8_t* m_ptr = nullptr;
+		std::vector<GLsync> m_fences;
+	};
+
+	// Frame-scoped linear allocator packing per-draw uniform blocks into a single StreamBuffer. Offsets are aligned to
+	// GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT and meant to be bound with bind_range(). Write all blocks for the frame, flush()
+	// once, then issue the draws.
+	class TransientUniformBuffer : public StreamBuffer
+	{
+	public:
+		TransientUniformBuffer(size_t size, uint32_t num_frames = 3);
+		~TransientUniformBuffer();
+
+		using StreamBuffer::allocate;
+
+		// Reserves an aligned uniform block of 'size' bytes in the current frame's region.
+		void* allocate(size_t size, size_t& offset);
+
+		// Copies a uniform block into the current frame's region. Returns false if the region is full.
+		bool push(const void* data, size_t size, size_t& offset);
+
+		size_t alignment();
+
+	private:
+		size_t m_alignment;
+	};
+
 	struct VertexAttrib
 	{
 		uint32_t num_sub_elements;
@@ -307,7 +440,7 @@ namespace dw
     class VertexArray
     {
     public:
-		VertexArray(VertexBuffer* vbo, IndexBuffer* ibo, size_t vertex_size, int attrib_count, VertexAttrib attribs[]);
+		VertexArray(Buffer* vbo, IndexBuffer* ibo, size_t vertex_size, int attrib_count, VertexAttrib attribs[]);
         ~VertexArray();
 		void bind();
 		void unbind();
@@ -316,6 +449,41 @@ namespace dw
         GLuint m_gl_vao;
     };
 
+	// Vertex array holding only a vertex layout (ARB_vertex_attrib_binding, core in GL 4.3). Buffers are attached
+	// separately, so every mesh sharing a layout is drawn through one vertex array and switching meshes only swaps
+	// buffer bindings instead of vertex arrays.
+	class VertexFormat
+	{
+	public:
+		// Returns true if the context supports separate vertex formats. Not available on WebGL.
+		static bool supported();
+		// Returns the shared format for the given layout, creating it on first use.
+		static VertexFormat* get(size_t vertex_size, int attrib_count, VertexAttrib attribs[]);
+		// Destroys every cached format.
+		static void clear_cache();
+
+		VertexFormat(size_t vertex_size, int attrib_count, VertexAttrib attribs[]);
+		~VertexFormat();
+		void bind();
+		void unbind();
+
+		// Attaches buffers to this format. The format must be bound. 'offset' is the byte offset of the first vertex.
+		void bind_buffers(Buffer* vbo, IndexBuffer* ibo, size_t offset = 0);
+
+		GLuint id();
+		size_t vertex_size();
+
+	private:
+		bool matches(size_t vertex_size, int attrib_count, VertexAttrib attribs[]);
+
+	private:
+		static std::vector<std::unique_ptr<VertexFormat>> m_cache;
+
+		GLuint m_gl_vao;
+		size_t m_vertex_size;
+		std::vector<VertexAttrib> m_attribs;
+	};
+
 	class Query
 	{
 	public:
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <stdint.h>
+#include <ogl.h>
+
+namespace dw
+{
+	struct BlendState
+	{
+		bool   enable = false;
+		GLenum src_rgb = GL_ONE;
+		GLenum dst_rgb = GL_ZERO;
+		GLenum src_alpha = GL_ONE;
+		GLenum dst_alpha = GL_ZERO;
+		GLenum op_rgb = GL_FUNC_ADD;
+		GLenum op_alpha = GL_FUNC_ADD;
+	};
+
+	struct DepthState
+	{
+		bool   test = true;
+		bool   write = true;
+		GLenum func = GL_LESS;
+	};
+
+	struct RasterState
+	{
+#if !defined(__EMSCRIPTEN__)
+		GLenum polygon_mode = GL_FILL;
+#endif
+		GLenum front_face = GL_CCW;
+		bool   scissor = false;
+	};
+
+	struct CullState
+	{
+		bool   enable = true;
+		GLenum face = GL_BACK;
+	};
+
+	struct PipelineStateDesc
+	{
+		Program*	 program = nullptr;
+		VertexArray* vertex_array = nullptr; // Vertex layout. Optional, e.g. for meshes drawn from different vertex arrays.
+		BlendState	 blend;
+		DepthState	 depth;
+		RasterState	 raster;
+		CullState	 cull;
+	};
+
+	// Immutable bundle of render state. Each state block is hashed once at creation so binding can skip unchanged
+	// blocks without comparing their fields.
+	class PipelineState
+	{
+	public:
+		PipelineState(const PipelineStateDesc& desc);
+		~PipelineState();
+
+		inline const PipelineStateDesc& desc()		   { return m_desc; }
+		inline uint64_t					 hash()		   { return m_hash; }
+		inline uint64_t					 blend_hash()  { return m_blend_hash; }
+		inline uint64_t					 depth_hash()  { return m_depth_hash; }
+		inline uint64_t					 raster_hash() { return m_raster_hash; }
+		inline uint64_t					 cull_hash()   { return m_cull_hash; }
+
+	private:
+		PipelineStateDesc m_desc;
+		uint64_t		  m_hash;
+		uint64_t		  m_blend_hash;
+		uint64_t		  m_depth_hash;
+		uint64_t		  m_raster_hash;
+		uint64_t		  m_cull_hash;
+	};
+
+	// Applies PipelineStates, issuing GL calls only for the fields that differ from the previously bound one. The
+	// binder shadows GL state instead of querying it, so code that changes blend, depth, raster or cull state with raw
+	// GL calls must call invalidate() before its next bind(). Application invalidates its binder at the start of every
+	// frame; within a frame, keeping the shadow in sync is the caller's job.
+	class PipelineStateBinder
+	{
+	public:
+		PipelineStateBinder();
+		~PipelineStateBinder();
+
+		void bind(PipelineState* pso);
+
+		// Forgets the shadowed state. The next bind() applies every field.
+		void invalidate();
+
+		inline PipelineState* current() { return m_current; }
+
+	private:
+		void apply_blend(const BlendState& state, const BlendState* previous);
+		void apply_depth(const DepthState& state, const DepthState* previous);
+		void apply_raster(const RasterState& state, const RasterState* previous);
+		void apply_cull(const CullState& state, const CullState* previous);
+
+	private:
+		PipelineState* m_current = nullptr;
+	};
+} // namespace dw
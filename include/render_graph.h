@@ -0,0 +1,136 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <functional>
+#include <ogl.h>
+#include <render_target_pool.h>
+
+#define RENDER_GRAPH_INVALID_RESOURCE 0xFFFFFFFF
+
+namespace dw
+{
+	typedef uint32_t RenderGraphResource;
+
+	enum RenderGraphUsage
+	{
+		RENDER_GRAPH_USAGE_SAMPLED = 0,	  // Read through a sampler.
+		RENDER_GRAPH_USAGE_IMAGE,		  // Image load/store, e.g. from a compute shader.
+		RENDER_GRAPH_USAGE_RENDER_TARGET, // Color attachment.
+		RENDER_GRAPH_USAGE_DEPTH_STENCIL  // Depth/stencil attachment.
+	};
+
+	class RenderGraph;
+
+	// Handed to a pass' setup callback to declare the resources it creates, reads and writes.
+	class RenderGraphBuilder
+	{
+	public:
+		// Declares a transient render target. Its texture only exists between the first and last pass using it.
+		RenderGraphResource create(const std::string& name, const RenderTargetDesc& desc);
+		RenderGraphResource read(RenderGraphResource resource, RenderGraphUsage usage = RENDER_GRAPH_USAGE_SAMPLED);
+		RenderGraphResource write(RenderGraphResource resource, RenderGraphUsage usage = RENDER_GRAPH_USAGE_RENDER_TARGET);
+
+		// Marks the pass as having effects outside the graph (e.g. drawing to the default framebuffer) so it is never culled.
+		void side_effect();
+
+	private:
+		friend class RenderGraph;
+
+		RenderGraphBuilder(RenderGraph* graph, uint32_t pass);
+
+	private:
+		RenderGraph* m_graph;
+		uint32_t	 m_pass;
+	};
+
+	// Handed to a pass' execute callback to look up the GL objects behind its declared resources.
+	class RenderGraphContext
+	{
+	public:
+		Texture2D* texture(RenderGraphResource resource);
+
+		// Framebuffer with the pass' render target writes attached in declaration order, plus its depth/stencil target.
+		// nullptr if the pass declared no attachments or they don't form a complete framebuffer.
+		Framebuffer* framebuffer();
+
+	private:
+		friend class RenderGraph;
+
+		RenderGraphContext(RenderGraph* graph, uint32_t pass);
+
+	private:
+		RenderGraph* m_graph;
+		uint32_t	 m_pass;
+	};
+
+	// Frame graph built on top of RenderTargetPool, Framebuffer and Texture2D.
+	//
+	// Passes are added with a setup callback, invoked immediately to declare resource accesses, and an execute callback
+	// that issues the GL work. A pass can only reference resources created or imported before it, so submission order is
+	// a valid execution order. compile() culls passes whose results never reach an imported resource or a side effect,
+	// computes the first and last use of every transient resource so the pool can alias them, and inserts glMemoryBarrier
+	// only after image stores that a later pass consumes.
+	//
+	// Typical frame: reset(), import()/add_pass()..., compile(), execute().
+	class RenderGraph
+	{
+	public:
+		RenderGraph(RenderTargetPool* pool);
+		~RenderGraph();
+
+		// Makes an externally owned texture available to passes. Writes to imported resources are never culled.
+		RenderGraphResource import(const std::string& name, Texture2D* texture);
+
+		void add_pass(const std::string& name, std::function<void(RenderGraphBuilder&)> setup, std::function<void(RenderGraphContext&)> execute);
+		void compile();
+		void execute();
+
+		// Removes every pass and resource. Transient textures have already been returned to the pool by execute().
+		void reset();
+
+		uint32_t pass_count();
+		uint32_t culled_pass_count();
+
+	private:
+		friend class RenderGraphBuilder;
+		friend class RenderGraphContext;
+
+		struct Access
+		{
+			RenderGraphResource resource;
+			RenderGraphUsage	usage;
+		};
+
+		struct Pass
+		{
+			std::string								 name;
+			std::function<void(RenderGraphContext&)> execute;
+			std::vector<Access>						 reads;
+			std::vector<Access>						 writes;
+			bool									 side_effect = false;
+			bool									 culled = true;
+			GLbitfield								 barriers = 0;
+			std::vector<RenderGraphResource>		 acquire;
+			std::vector<RenderGraphResource>		 release;
+		};
+
+		struct Resource
+		{
+			std::string			  name;
+			RenderTargetDesc	  desc;
+			Texture2D*			  texture = nullptr;
+			bool				  imported = false;
+			std::vector<uint32_t> writers;
+		};
+
+		bool valid(RenderGraphResource resource);
+
+	private:
+		RenderTargetPool*	  m_pool;
+		std::vector<Pass>	  m_passes;
+		std::vector<Resource> m_resources;
+		bool				  m_compiled = false;
+	};
+} // namespace dw
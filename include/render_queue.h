@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <ogl.h>
+
+namespace dw
+{
+	class Mesh;
+	class Material;
+
+	enum RenderPass
+	{
+		RENDER_PASS_OPAQUE = 0,
+		RENDER_PASS_ALPHA_TESTED = 1,
+		RENDER_PASS_TRANSPARENT = 2,
+		RENDER_PASS_OVERLAY = 3
+	};
+
+	struct RenderItem
+	{
+		uint64_t  key;
+		Program*  program;
+		Mesh*	  mesh;
+		uint32_t  sub_mesh;
+		Material* material;
+		uint32_t  user_data;
+	};
+
+	// Collects draws, sorts them by a 64-bit key with a radix sort and submits them with redundant Program, vertex buffer
+	// and Material texture binds removed.
+	//
+	// Key layout, most significant bits first:
+	//   Opaque/alpha tested : [pass:4][depth bucket:4][program:12][material:16][vertex buffer:12][depth:16]
+	//   Transparent/overlay : [pass:4][inverted depth:24][program:12][material:12][vertex buffer:12]
+	// Opaque passes are grouped by state and drawn roughly front-to-back inside each depth bucket, transparent passes
+	// are drawn strictly back-to-front. Where VertexFormat is supported, meshes are drawn through their shared layout
+	// and only vertex and index buffers are swapped between them.
+	class RenderQueue
+	{
+	public:
+		RenderQueue(uint32_t initial_capacity = 1024);
+		~RenderQueue();
+
+		// Range used to quantize view-space distances. Typically the camera near and far planes.
+		void set_depth_range(float near, float far);
+
+		// Number of coarse front-to-back buckets for opaque passes (1 - 16). More buckets trade state changes for overdraw.
+		void set_opaque_depth_buckets(uint32_t count);
+
+		// Removes all items. Call at the start of every frame.
+		void clear();
+
+		// Queues a SubMesh draw. 'distance' is the view-space distance used for depth ordering. 'user_data' is passed back
+		// through the per-draw callback, e.g. as an offset into a TransientUniformBuffer.
+		void push(RenderPass pass, Program* program, Mesh* mesh, uint32_t sub_mesh, float distance, uint32_t user_data = 0);
+
+		// Sorts queued items by key.
+		void sort();
+
+		// Issues the sorted draws. Material textures are bound to the unit matching their index. The optional callback
+		// is invoked before every draw to bind per-draw data.
+		void submit(std::function<void(const RenderItem&)> per_draw = nullptr);
+
+		inline uint32_t	   size()  { return m_items.size(); }
+		inline RenderItem* items() { return m_items.data(); }
+
+	private:
+		struct SortEntry
+		{
+			uint64_t key;
+			uint32_t index;
+		};
+
+		uint64_t make_key(RenderPass pass, Program* program, Mesh* mesh, Material* material, float distance);
+		uint32_t id_for(std::unordered_map<void*, uint32_t>& ids, void* ptr);
+
+	private:
+		float m_near = 0.1f;
+		float m_far = 1000.0f;
+		uint32_t m_depth_buckets = 1;
+		std::vector<RenderItem> m_items;
+		std::vector<RenderItem> m_sorted_items;
+		std::vector<SortEntry> m_entries;
+		std::vector<SortEntry> m_scratch;
+		std::unordered_map<void*, uint32_t> m_program_ids;
+		std::unordered_map<void*, uint32_t> m_material_ids;
+		std::unordered_map<void*, uint32_t> m_buffer_ids;
+	};
+} // namespace dw
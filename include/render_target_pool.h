@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <memory>
+#include <unordered_set>
+#include <ogl.h>
+
+namespace dw
+{
+	struct RenderTargetDesc
+	{
+		uint32_t width;
+		uint32_t height;
+		GLenum	 internal_format;
+		GLenum	 format;
+		GLenum	 type;
+		uint32_t num_samples = 1;
+		uint32_t array_size = 1;
+		int32_t	 mip_levels = 1;
+
+		bool operator==(const RenderTargetDesc& other) const;
+	};
+
+	// Hands out transient render targets and framebuffers by descriptor instead of having every pass own them.
+	//
+	// A target acquired by one pass and released once that pass has been consumed can be handed to a later pass in
+	// the same frame, so passes whose lifetimes don't overlap share memory. Targets and framebuffers left unused for
+	// 'max_unused_frames' frames are destroyed, which takes care of stale sizes after a resize. Framebuffer
+	// completeness is validated once per unique attachment configuration rather than on every attach.
+	class RenderTargetPool
+	{
+	public:
+		RenderTargetPool(uint32_t max_unused_frames = 2);
+		~RenderTargetPool();
+
+		// Ages pooled resources and destroys the ones unused for too long. Call once per frame before acquiring.
+		void begin_frame();
+
+		// Returns a target matching the descriptor that is not currently acquired, creating one if needed. A target may be
+		// held across frames (e.g. a history buffer) and is kept alive until released.
+		Texture2D* acquire(const RenderTargetDesc& desc);
+
+		// Returns a target to the pool. Later acquire() calls in the same frame may reuse it.
+		void release(Texture2D* texture);
+
+		// Returns a framebuffer with the given color targets attached to consecutive attachments and an optional
+		// depth target. Framebuffers are cached by attachment set and reused across frames. Returns nullptr if the
+		// attachments don't form a complete framebuffer.
+		Framebuffer* framebuffer(uint32_t color_count, Texture2D** color, Texture2D* depth = nullptr);
+
+		// Destroys every pooled target and framebuffer. Acquired targets become invalid.
+		void clear();
+
+		inline uint32_t target_count()		{ return m_targets.size(); }
+		inline uint32_t framebuffer_count() { return m_framebuffers.size(); }
+
+	private:
+		struct PooledTarget
+		{
+			RenderTargetDesc		   desc;
+			std::unique_ptr<Texture2D> texture;
+			bool					   in_use;
+			uint32_t				   last_used_frame;
+		};
+
+		struct PooledFramebuffer
+		{
+			std::vector<GLuint>			 attachments; // Color texture ids followed by the depth texture id (or 0).
+			std::unique_ptr<Framebuffer> fbo;
+			uint32_t					 last_used_frame;
+		};
+
+		uint64_t configuration_hash(uint32_t color_count, Texture2D** color, Texture2D* depth);
+
+	private:
+		uint32_t m_max_unused_frames;
+		uint32_t m_frame = 0;
+		std::vector<PooledTarget> m_targets;
+		std::vector<PooledFramebuffer> m_framebuffers;
+		std::unordered_set<uint64_t> m_validated_configurations;
+	};
+} // namespace dw
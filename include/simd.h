@@ -0,0 +1,15 @@
+#pragma once
+
+// SIMD instruction sets available to the library's CPU kernels. Only included from source files so the intrinsics
+// headers don't leak into the public headers.
+//
+// DW_SIMD_SSE: SSE2, always available on x86-64.
+// DW_SIMD_AVX: AVX, when building with USE_AVX.
+#if defined(__AVX__)
+#include <immintrin.h>
+#define DW_SIMD_AVX
+#define DW_SIMD_SSE
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DW_SIMD_SSE
+#endif
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+namespace dw
+{
+#if !defined(__EMSCRIPTEN__)
+	// Splits offline work across local processes. The launcher re-runs the current executable 'worker_count' times with
+	// '--headless --farm-worker <index>' appended, so every worker gets its own offscreen context (and may be pointed at
+	// a different GPU through the environment). Workers write their share to part files which the launcher merges once
+	// all of them have exited; the merge is the only serial step.
+	//
+	// Application drives this through '--farm-workers <count>'. See Application::farm_merge().
+	class TileFarm
+	{
+	public:
+		// Spawns the workers and waits for them. Returns false if any worker failed.
+		static bool launch(int argc, const char* argv[], uint32_t worker_count);
+
+		// Splits 'total' items into contiguous ranges and returns the range of 'worker'.
+		static void split(uint32_t total, uint32_t worker, uint32_t worker_count, uint32_t& first, uint32_t& count);
+
+		// Path of the part file written by 'worker' for the output 'path'.
+		static std::string part_path(const std::string& path, uint32_t worker);
+
+		// Merges the strips written by TiledCapture::capture_strips() on every worker into a single PPM.
+		static bool merge_tiled_capture(const std::string& path, uint32_t width, uint32_t height, uint32_t worker_count);
+
+		// Merges the Y4M streams recorded by every worker into one, keeping the header of the first.
+		static bool merge_y4m(const std::string& path, uint32_t worker_count);
+	};
+#endif
+} // namespace dw
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <glm.hpp>
+#include <ogl.h>
+
+namespace dw
+{
+#if !defined(__EMSCRIPTEN__)
+	// Renders images larger than the GPU can hold (e.g. 16k x 16k) as a grid of tiles. Every tile is drawn into the
+	// same tile-sized render target with an off-center projection covering its part of the full frustum, and is read
+	// back and written out one strip of tiles at a time, so neither VRAM nor system memory ever holds the full image.
+	//
+	// Output is binary PPM, which can be written incrementally row by row.
+	class TiledCapture
+	{
+	public:
+		// Renders the scene into the bound 'fbo' using 'projection' in place of the camera projection. The viewport is
+		// already set to the tile size.
+		using RenderCallback = std::function<void(Framebuffer* fbo, const glm::mat4& projection, uint32_t width, uint32_t height)>;
+
+		// 'tile_size' is clamped to GL_MAX_TEXTURE_SIZE and GL_MAX_VIEWPORT_DIMS.
+		TiledCapture(uint32_t tile_size = 2048);
+		~TiledCapture();
+
+		// Captures a 'width' x 'height' image of the view seen through 'projection' (e.g. Camera::m_projection) to 'path'.
+		bool capture(const std::string& path, uint32_t width, uint32_t height, const glm::mat4& projection, RenderCallback render);
+
+		// Renders only strips [first_strip, first_strip + strip_count) and writes their rows without a header. Used to
+		// split a capture across processes, see TileFarm.
+		bool capture_strips(const std::string& path, uint32_t width, uint32_t height, const glm::mat4& projection, RenderCallback render, uint32_t first_strip, uint32_t strip_count);
+
+		// Number of strips (rows of tiles) making up an image of the given height.
+		uint32_t num_strips(uint32_t height);
+
+		// Returns the projection covering the pixel rectangle [x0, x1) x [y0, y1) of a 'width' x 'height' image, with
+		// y measured from the bottom as in GL window coordinates.
+		static glm::mat4 tile_projection(const glm::mat4& projection, uint32_t width, uint32_t height, uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1);
+
+		inline uint32_t tile_size() { return m_tile_size; }
+
+	private:
+		bool create_target();
+		void write_strips(FILE* file, uint32_t width, uint32_t height, const glm::mat4& projection, RenderCallback& render, uint32_t first_strip, uint32_t strip_count);
+
+	private:
+		uint32_t					 m_tile_size;
+		std::unique_ptr<Texture2D>	 m_color;
+		std::unique_ptr<Texture2D>	 m_depth;
+		std::unique_ptr<Framebuffer> m_fbo;
+	};
+#endif
+} // namespace dw
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <ogl.h>
+
+// Shader storage binding points used for Mesh vertex and index data.
+#define VERTEX_PULLING_VERTEX_BINDING 6
+#define VERTEX_PULLING_INDEX_BINDING 7
+// Explicit location of the 'u_BaseVertex' uniform. The highest location every GL 4.3 implementation supports.
+#define VERTEX_PULLING_BASE_VERTEX_LOCATION 1023
+
+namespace dw
+{
+	class Mesh;
+
+#if !defined(__EMSCRIPTEN__)
+	// Draws Meshes without vertex attributes. Vertex and index buffers are bound as shader storage buffers (no copy is
+	// made) and the vertex shader fetches its own data using gl_VertexID, so meshes with different layouts or packed
+	// formats the fixed-function path cannot decode are drawn through the same empty vertex array.
+	//
+	// Vertex shaders prepend glsl_source() to their source before creating the Shader, which adds the #version line
+	// itself, and call pull_vertex() to get the current vertex of the standard Vertex layout. Custom layouts bind their
+	// own storage buffers and decode them the same way.
+	class VertexPulling
+	{
+	public:
+		// Requires shader storage buffers (GL 4.3).
+		static bool supported();
+
+		// GLSL declarations of the mesh storage buffers, the 'u_BaseVertex' uniform and pull_vertex().
+		static const std::string& glsl_source();
+
+		VertexPulling();
+		~VertexPulling();
+
+		// Binds the empty vertex array. Must be bound for every pulled draw since core contexts reject draws without one.
+		void bind();
+
+		// Binds the Mesh's vertex and index buffers to the storage buffer binding points.
+		void bind_mesh(Mesh* mesh);
+
+		// Draws one SubMesh with glDrawArrays. The Program must be bound; its 'u_BaseVertex' uniform is set here.
+		void draw(Mesh* mesh, uint32_t sub_mesh);
+
+	private:
+		GLuint m_gl_vao;
+	};
+#endif
+} // namespace dw
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dw
+{
+	// Worker threads shared by the framework's parallel CPU work (batch culling, occlusion rasterization). Created on
+	// first use and kept for the lifetime of the program, so per-frame work doesn't pay for thread creation.
+	class WorkerPool
+	{
+	public:
+		static WorkerPool& get();
+
+		// Runs job(0) to job(count - 1), job(0) on the calling thread, and returns once all of them finished. One batch
+		// runs at a time and callers on other threads wait, so jobs must not call run() themselves.
+		void run(uint32_t count, const std::function<void(uint32_t)>& job);
+
+	private:
+		WorkerPool();
+		~WorkerPool();
+
+		void worker();
+
+	private:
+		std::mutex							 m_run_mutex;
+		std::mutex							 m_mutex;
+		std::condition_variable				 m_wake;
+		std::condition_variable				 m_done;
+		std::vector<std::thread>			 m_threads;
+		const std::function<void(uint32_t)>* m_job = nullptr;
+		uint32_t							 m_next = 0;
+		uint32_t							 m_count = 0;
+		uint32_t							 m_pending = 0;
+		bool								 m_stop = false;
+	};
+} // namespace dw
@@ -83,9 +83,6 @@ protected:
     
 	bool init(int argc, const char* argv[]) override
 	{
-        // Set initial GPU states.
-        set_initial_states();
-        
 		// Create GPU resources.
 		if (!create_shaders())
 			return false;
@@ -97,6 +94,9 @@ protected:
 		if (!load_mesh())
 			return false;
 
+		// Create render state.
+		create_pipeline_state();
+
 		// Create camera.
 		create_camera();
 
@@ -115,6 +115,14 @@ protected:
 
 		// Render.
 		render();
+
+#if !defined(__EMSCRIPTEN__)
+		// Show GPU timings.
+		if (ImGui::Begin("GPU Profiler"))
+			m_gpu_profiler.ui();
+
+		ImGui::End();
+#endif
 	}
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
@@ -175,25 +183,15 @@ private:
 			return false;
 		}
         
-        m_program->uniform_block_binding("Transforms", 0);
-        
 		return true;
 	}
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
 
-	void set_initial_states()
-	{
-        glEnable(GL_DEPTH_TEST);
-        glCullFace(GL_BACK);
-	}
-
-	// -----------------------------------------------------------------------------------------------------------------------------------
-
 	bool create_uniform_buffer()
 	{
-		// Create uniform buffer for matrix data
-        m_ubo = std::make_unique<dw::UniformBuffer>(GL_DYNAMIC_DRAW, sizeof(Transforms), nullptr);
+		// Create per-frame uniform allocator for matrix data
+        m_ubo = std::make_unique<dw::TransientUniformBuffer>(sizeof(Transforms) * 64);
 
 		return true;
 	}
@@ -208,6 +206,19 @@ private:
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
 
+	void create_pipeline_state()
+	{
+		dw::PipelineStateDesc desc;
+
+		desc.program = m_program.get();
+		desc.vertex_array = m_mesh->mesh_vertex_array();
+		desc.cull.enable = false;
+
+		m_pso = std::make_unique<dw::PipelineState>(desc);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
 	void create_camera()
 	{
         m_main_camera = std::make_unique<dw::Camera>(60.0f, 0.1f, 1000.0f, float(m_width)/float(m_height), glm::vec3(0.0f, 0.0f, 100.0f), glm::vec3(0.0f, 0.0, -1.0f));
@@ -217,25 +228,23 @@ private:
 
 	void render()
 	{
+#if !defined(__EMSCRIPTEN__)
+		DW_GPU_PROFILER_SCOPE(m_gpu_profiler, "Render");
+#endif
+
 		// Bind framebuffer and set viewport.
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        bind_default_framebuffer();
         glViewport(0, 0, m_width, m_height);
         
 		// Clear default framebuffer.
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		// Bind shader program.
-        m_program->use();
+		// Bind shader program, vertex array and render state.
+        m_pipeline_state_binder.bind(m_pso.get());
 
-		// Bind uniform buffer.
-        m_ubo->bind_base(0);
-
-		// Bind vertex array.
-        m_mesh->mesh_vertex_array()->bind();
-        
-        // Set active texture unit uniform
-        m_program->set_uniform("s_Diffuse", 0);
+		// Bind this frame's uniform data.
+        m_ubo->bind_range(0, m_ubo_offset, sizeof(Transforms));
 
 		for (uint32_t i = 0; i < m_mesh->sub_mesh_count(); i++)
 		{
@@ -245,8 +254,11 @@ private:
             submesh.mat->texture(0)->bind(0);
 
 			// Issue draw call.
-            glDrawElementsBaseVertex(GL_TRIANGLES, submesh.index_count, GL_UNSIGNED_INT, (void*)(sizeof(unsigned int) * submesh.base_index), submesh.base_vertex);
+            glDrawElementsBaseVertex(GL_TRIANGLES, submesh.index_count, GL_UNSIGNED_INT, (void*)(sizeof(unsigned int) * (m_mesh->base_index() + submesh.base_index)), m_mesh->base_vertex() + submesh.base_vertex);
 		}
+
+		// Fence this frame's uniform region.
+		m_ubo->end_frame();
 	}
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
@@ -260,9 +272,9 @@ private:
 		m_transforms.view = m_main_camera->m_view;
 		m_transforms.projection = m_main_camera->m_projection;
 
-        void* ptr = m_ubo->map(GL_WRITE_ONLY);
-		memcpy(ptr, &m_transforms, sizeof(Transforms));
-        m_ubo->unmap();
+        m_ubo->begin_frame();
+        m_ubo->push(&m_transforms, sizeof(Transforms), m_ubo_offset);
+        m_ubo->flush();
 	}
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
@@ -272,7 +284,9 @@ private:
     std::unique_ptr<dw::Shader> m_vs;
 	std::unique_ptr<dw::Shader> m_fs;
 	std::unique_ptr<dw::Program> m_program;
-	std::unique_ptr<dw::UniformBuffer> m_ubo;
+	std::unique_ptr<dw::PipelineState> m_pso;
+	std::unique_ptr<dw::TransientUniformBuffer> m_ubo;
+	size_t m_ubo_offset = 0;
 
     // Camera.
     std::unique_ptr<dw::Camera> m_main_camera;
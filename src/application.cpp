@@ -1,5 +1,7 @@
 #include <application.h>
 #include <iostream>
+#include <string.h>
+#include <stdlib.h>
 #include <imgui_impl_glfw_gl3.h>
 
 #if defined(__EMSCRIPTEN__)
@@ -20,7 +22,7 @@ namespace dw
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
 
-    Application::Application() : m_mouse_x(0.0), m_mouse_y(0.0), m_last_mouse_x(0.0), m_last_mouse_y(0.0), m_mouse_delta_x(0.0), m_mouse_delta_y(0.0), m_delta(0.0), m_delta_seconds(0.0), m_window(nullptr)
+    Application::Application() : m_mouse_x(0.0), m_mouse_y(0.0), m_last_mouse_x(0.0), m_last_mouse_y(0.0), m_mouse_delta_x(0.0), m_mouse_delta_y(0.0), m_delta(0.0), m_delta_seconds(0.0), m_fixed_delta(0.0), m_time(0.0), m_window(nullptr), m_headless(false), m_max_frames(0), m_frame_count(0), m_farm_worker(-1), m_farm_workers(0)
     {
         
     }
@@ -36,6 +38,14 @@ namespace dw
     
     int Application::run(int argc, const char* argv[])
     {
+#if !defined(__EMSCRIPTEN__)
+		AppSettings settings = intial_app_settings();
+		parse_arguments(argc, argv, settings);
+
+		if (settings.farm_workers > 0 && settings.farm_worker < 0)
+			return run_farm(argc, argv, settings);
+#endif
+
         if(!init_base(argc, argv))
             return 1;
         
@@ -84,6 +94,7 @@ namespace dw
         
         // Defaults
 		AppSettings settings = intial_app_settings();
+		parse_arguments(argc, argv, settings);
 
         bool resizable = settings.resizable;
         bool maximized = settings.maximized;
@@ -91,6 +102,49 @@ namespace dw
 		m_width = settings.width;
 		m_height = settings.height;
 		m_title = settings.title;
+		m_headless = settings.headless;
+		m_max_frames = settings.max_frames;
+		std::string record_path = settings.record_path;
+		m_farm_worker = settings.farm_worker;
+		m_farm_workers = settings.farm_workers;
+
+#if !defined(__EMSCRIPTEN__)
+		if (m_farm_worker >= 0 && uint32_t(m_farm_worker) >= m_farm_workers)
+		{
+			DW_LOG_ERROR("Farm worker index " + std::to_string(m_farm_worker) + " is out of range for " + std::to_string(m_farm_workers) + " workers.");
+			return false;
+		}
+
+		// Farm workers render their own contiguous range of frames, numbered as in a single run.
+		if (m_farm_worker >= 0 && m_max_frames > 0)
+		{
+			uint32_t first, count;
+			TileFarm::split(m_max_frames, m_farm_worker, m_farm_workers, first, count);
+
+			m_frame_count = first;
+			m_max_frames = first + count;
+		}
+
+		// Recordings and farm workers advance a fixed 1 / refresh rate per frame, so frame N shows the same moment no
+		// matter how long frames take to render or which worker renders them.
+		if (!record_path.empty() || m_farm_worker >= 0)
+		{
+			m_fixed_delta = 1000.0 / std::max(refresh_rate, 1);
+			m_delta = m_fixed_delta;
+			m_delta_seconds = m_fixed_delta / 1000.0;
+		}
+#endif
+
+#if defined(__EMSCRIPTEN__)
+		if (m_headless)
+		{
+			DW_LOG_WARNING("Headless mode is not supported on this platform.");
+			m_headless = false;
+		}
+
+		if (!record_path.empty())
+			DW_LOG_WARNING("Frame recording is not supported on this platform.");
+#endif
         
 		int major_ver = 4;
 #if defined(__APPLE__)
@@ -117,7 +171,16 @@ namespace dw
 
 #if !defined(__EMSCRIPTEN__)
         glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-        glfwWindowHint(GLFW_SAMPLES, 8);
+        glfwWindowHint(GLFW_SAMPLES, m_headless ? 0 : 8);
+
+		if (m_headless)
+		{
+			// The window only owns the context. Frames are rendered into an internal framebuffer instead.
+			glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#if defined(DWSFW_USE_OSMESA)
+			glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+#endif
+		}
 #endif
 
 #if __APPLE__
@@ -158,7 +221,29 @@ namespace dw
         m_width = display_w;
         m_height = display_h;
 
-		if (!m_debug_draw.init())
+		if (m_headless)
+		{
+			if (!create_headless_framebuffer())
+				return false;
+
+			DW_LOG_INFO("Running headless at " + std::to_string(m_width) + "x" + std::to_string(m_height));
+		}
+
+#if !defined(__EMSCRIPTEN__)
+		if (!record_path.empty())
+		{
+			bool y4m = record_path.size() > 4 && record_path.compare(record_path.size() - 4, 4, ".y4m") == 0;
+
+			// Y4M streams can't be written from several processes, so workers record parts that the launcher merges.
+			if (y4m && m_farm_worker >= 0)
+				record_path = TileFarm::part_path(record_path, m_farm_worker);
+
+			if (!m_frame_recorder.start(record_path, y4m ? FRAME_RECORDER_FORMAT_Y4M : FRAME_RECORDER_FORMAT_PNG, m_width, m_height, settings.refresh_rate, 0, 8, m_frame_count))
+				return false;
+		}
+#endif
+
+		if (!m_debug_draw.init(&m_pipeline_state_binder))
 			return false;
         
         if(!init(argc, argv))
@@ -186,6 +271,23 @@ namespace dw
 		// Shutdown debug draw.
 		m_debug_draw.shutdown();
 
+#if !defined(__EMSCRIPTEN__)
+		// Release GPU profiler queries.
+		m_gpu_profiler.shutdown();
+
+		// Write out frames still in flight.
+		m_frame_recorder.stop();
+#endif
+
+		// Release headless framebuffer before the context goes away.
+		m_headless_fbo.reset();
+		m_headless_color.reset();
+		m_headless_depth.reset();
+
+		// Release cached samplers and vertex formats before the context goes away.
+		Sampler::clear_cache();
+		VertexFormat::clear_cache();
+
 		// Shutdown ImGui.
 		ImGui_ImplGlfwGL3_Shutdown();
 		ImGui::DestroyContext();
@@ -204,9 +306,16 @@ namespace dw
     void Application::begin_frame()
     {
         m_timer.start();
+
+		// Nothing guarantees GL state still matches the shadowed PSO from the previous frame.
+		m_pipeline_state_binder.invalidate();
         
         glfwPollEvents();
         ImGui_ImplGlfwGL3_NewFrame();
+
+#if !defined(__EMSCRIPTEN__)
+        m_gpu_profiler.begin_frame();
+#endif
         
         m_mouse_delta_x = m_mouse_x - m_last_mouse_x;
         m_mouse_delta_y = m_mouse_y - m_last_mouse_y;
@@ -219,13 +328,31 @@ namespace dw
     
     void Application::end_frame()
     {
+		bind_default_framebuffer();
+
+#if !defined(__EMSCRIPTEN__)
+		// Captured before the UI is drawn so recordings only contain the rendered frame.
+		m_frame_recorder.capture(m_headless_fbo.get(), m_width, m_height);
+#endif
+
         ImGui::Render();
 		ImGui_ImplGlfwGL3_RenderDrawData(ImGui::GetDrawData());
-        glfwSwapBuffers(m_window);
+
+		// Nothing to present when headless. The frame stays in the internal framebuffer.
+		if (!m_headless)
+			glfwSwapBuffers(m_window);
+
+		m_frame_count++;
         
         m_timer.stop();
-        m_delta = m_timer.elapsed_time_milisec();
-		m_delta_seconds = m_timer.elapsed_time_sec();
+
+		if (m_fixed_delta == 0.0)
+		{
+			m_delta = m_timer.elapsed_time_milisec();
+			m_delta_seconds = m_timer.elapsed_time_sec();
+		}
+
+		m_time += m_delta_seconds;
     }
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
@@ -239,17 +366,113 @@ namespace dw
     
     bool Application::exit_requested() const
     {
-        return glfwWindowShouldClose(m_window);
+        return glfwWindowShouldClose(m_window) || (m_max_frames > 0 && m_frame_count >= m_max_frames);
     }
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
 
+	void Application::bind_default_framebuffer()
+	{
+		if (m_headless_fbo)
+			m_headless_fbo->bind();
+		else
+		{
+			GL_CHECK_ERROR(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	bool Application::create_headless_framebuffer()
+	{
+		m_headless_color = std::make_unique<Texture2D>(m_width, m_height, 1, 1, 1, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+		m_headless_depth = std::make_unique<Texture2D>(m_width, m_height, 1, 1, 1, GL_DEPTH_COMPONENT32F, GL_DEPTH_COMPONENT, GL_FLOAT);
+		m_headless_fbo = std::make_unique<Framebuffer>();
+
+		m_headless_fbo->set_validation(false);
+		m_headless_fbo->attach_render_target(0, m_headless_color.get(), 0, 0);
+		m_headless_fbo->attach_depth_stencil_target(m_headless_depth.get(), 0, 0);
+
+		if (!m_headless_fbo->validate())
+		{
+			DW_LOG_FATAL("Failed to create headless framebuffer!");
+			return false;
+		}
+
+		return true;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
 	AppSettings Application::intial_app_settings()
 	{
 		return AppSettings();
 	}
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	bool Application::farm_merge(uint32_t worker_count)
+	{
+		return true;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void Application::parse_arguments(int argc, const char* argv[], AppSettings& settings)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			if (strcmp(argv[i], "--headless") == 0)
+				settings.headless = true;
+			else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+				settings.max_frames = uint32_t(atoi(argv[++i]));
+			else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+				settings.record_path = argv[++i];
+			else if (strcmp(argv[i], "--farm-workers") == 0 && i + 1 < argc)
+				settings.farm_workers = uint32_t(atoi(argv[++i]));
+			else if (strcmp(argv[i], "--farm-worker") == 0 && i + 1 < argc)
+				settings.farm_worker = atoi(argv[++i]);
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	int Application::run_farm(int argc, const char* argv[], const AppSettings& settings)
+	{
+#if defined(__EMSCRIPTEN__)
+		return 1;
+#else
+		logger::initialize();
+		logger::open_console_stream();
+
+		m_farm_workers = settings.farm_workers;
+
+		// Workers only exit after '--frames' unless the app ends them itself.
+		if (settings.max_frames == 0 && !settings.farm_exits_itself)
+		{
+			DW_LOG_ERROR("A frame farm needs '--frames <count>' so its workers exit.");
+			logger::close_console_stream();
+			return 1;
+		}
+
+		bool success = TileFarm::launch(argc, argv, m_farm_workers);
+
+		// Merging is the only serial step, done once every worker has exited.
+		const std::string& record_path = settings.record_path;
+
+		if (success && record_path.size() > 4 && record_path.compare(record_path.size() - 4, 4, ".y4m") == 0)
+			success = TileFarm::merge_y4m(record_path, m_farm_workers);
+
+		if (success)
+			success = farm_merge(m_farm_workers);
+
+		logger::close_console_stream();
+
+		return success ? 0 : 1;
+#endif
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
     
     void Application::window_resized(int width, int height)
     {
@@ -0,0 +1,560 @@
+#include <bvh.h>
+#include <algorithm>
+#include <float.h>
+
+namespace dw
+{
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	static AABB merge(const AABB& a, const AABB& b)
+	{
+		AABB result;
+
+		result.min = glm::min(a.min, b.min);
+		result.max = glm::max(a.max, b.max);
+
+		return result;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	static float surface_area(const AABB& aabb)
+	{
+		glm::vec3 e = aabb.max - aabb.min;
+		return 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	static AABB empty_aabb()
+	{
+		AABB aabb;
+
+		aabb.min = glm::vec3(FLT_MAX);
+		aabb.max = glm::vec3(-FLT_MAX);
+
+		return aabb;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	// Slab test. Returns the entry distance, or a negative value if the ray misses within 't_max'.
+	static float intersect_ray(const AABB& aabb, const glm::vec3& origin, const glm::vec3& inv_direction, float t_max)
+	{
+		glm::vec3 t0 = (aabb.min - origin) * inv_direction;
+		glm::vec3 t1 = (aabb.max - origin) * inv_direction;
+		glm::vec3 t_near = glm::min(t0, t1);
+		glm::vec3 t_far = glm::max(t0, t1);
+
+		float enter = std::max(std::max(t_near.x, t_near.y), std::max(t_near.z, 0.0f));
+		float exit = std::min(std::min(t_far.x, t_far.y), std::min(t_far.z, t_max));
+
+		return enter <= exit ? enter : -1.0f;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	BVH::BVH() {}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	BVH::~BVH() {}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	uint32_t BVH::insert(const AABB& aabb, void* user_data)
+	{
+		uint32_t object;
+
+		if (m_free_objects.empty())
+		{
+			object = uint32_t(m_objects.size());
+			m_objects.push_back(Object());
+		}
+		else
+		{
+			object = m_free_objects.back();
+			m_free_objects.pop_back();
+		}
+
+		uint32_t leaf = allocate_node();
+
+		m_nodes[leaf].aabb = aabb;
+		m_nodes[leaf].object = object;
+
+		m_objects[object].aabb = aabb;
+		m_objects[object].user_data = user_data;
+		m_objects[object].leaf = leaf;
+
+		insert_leaf(leaf);
+		m_object_count++;
+
+		return object;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void BVH::remove(uint32_t object)
+	{
+		uint32_t leaf = m_objects[object].leaf;
+
+		remove_leaf(leaf);
+		free_node(leaf);
+
+		m_objects[object].leaf = BVH_NULL;
+		m_free_objects.push_back(object);
+		m_object_count--;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void BVH::update(uint32_t object, const AABB& aabb)
+	{
+		uint32_t leaf = m_objects[object].leaf;
+
+		m_objects[object].aabb = aabb;
+		m_nodes[leaf].aabb = aabb;
+
+		refit_ancestors(m_nodes[leaf].parent);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void BVH::build()
+	{
+		std::vector<uint32_t> objects;
+
+		objects.reserve(m_object_count);
+
+		for (uint32_t i = 0; i < m_objects.size(); i++)
+		{
+			if (m_objects[i].leaf != BVH_NULL)
+				objects.push_back(i);
+		}
+
+		m_nodes.clear();
+		m_free_nodes.clear();
+		m_nodes.reserve(objects.size() * 2);
+
+		m_root = objects.empty() ? BVH_NULL : build_recursive(objects.data(), uint32_t(objects.size()), BVH_NULL);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void BVH::refit()
+	{
+		// Children are always allocated after their parent by build(), but incremental inserts may break that order, so
+		// walk the tree in post-order instead of relying on indices.
+		if (m_root == BVH_NULL)
+			return;
+
+		m_stack.clear();
+
+		uint32_t node = m_root;
+		uint32_t last = BVH_NULL;
+
+		while (node != BVH_NULL || !m_stack.empty())
+		{
+			if (node != BVH_NULL)
+			{
+				m_stack.push_back(node);
+				node = m_nodes[node].object == BVH_NULL ? m_nodes[node].left : BVH_NULL;
+			}
+			else
+			{
+				uint32_t top = m_stack.back();
+				Node&	 n = m_nodes[top];
+
+				if (n.object == BVH_NULL && last != n.right)
+					node = n.right;
+				else
+				{
+					if (n.object == BVH_NULL)
+						n.aabb = merge(m_nodes[n.left].aabb, m_nodes[n.right].aabb);
+
+					last = top;
+					m_stack.pop_back();
+				}
+			}
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void BVH::query(const Frustum& frustum, std::vector<uint32_t>& objects)
+	{
+		if (m_root == BVH_NULL)
+			return;
+
+		// Node and the plane mask it inherited from its parent, packed into one entry.
+		std::vector<uint64_t> stack;
+
+		stack.push_back((uint64_t(FRUSTUM_PLANE_MASK_ALL) << 32) | m_root);
+
+		while (!stack.empty())
+		{
+			uint64_t entry = stack.back();
+			stack.pop_back();
+
+			uint32_t	node = uint32_t(entry);
+			uint32_t	mask = uint32_t(entry >> 32);
+			const Node& n = m_nodes[node];
+
+			if (mask != 0 && !intersects(frustum, n.aabb, mask))
+				continue;
+
+			if (n.object != BVH_NULL)
+				objects.push_back(n.object);
+			else if (mask == 0)
+				collect(node, objects);
+			else
+			{
+				stack.push_back((uint64_t(mask) << 32) | n.right);
+				stack.push_back((uint64_t(mask) << 32) | n.left);
+			}
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void BVH::raycast(const glm::vec3& origin, const glm::vec3& direction, float t_max, RayCallback callback)
+	{
+		if (m_root == BVH_NULL)
+			return;
+
+		glm::vec3 inv_direction = 1.0f / direction;
+
+		m_stack.clear();
+		m_stack.push_back(m_root);
+
+		while (!m_stack.empty())
+		{
+			uint32_t	node = m_stack.back();
+			const Node& n = m_nodes[node];
+
+			m_stack.pop_back();
+
+			float t = intersect_ray(n.aabb, origin, inv_direction, t_max);
+
+			if (t < 0.0f)
+				continue;
+
+			if (n.object != BVH_NULL)
+			{
+				t_max = callback(n.object, t, t_max);
+				continue;
+			}
+
+			float t_left = intersect_ray(m_nodes[n.left].aabb, origin, inv_direction, t_max);
+			float t_right = intersect_ray(m_nodes[n.right].aabb, origin, inv_direction, t_max);
+
+			// Push the farther child first so the nearer one is visited first and can shrink 't_max'.
+			if (t_left >= 0.0f && t_right >= 0.0f)
+			{
+				if (t_left < t_right)
+				{
+					m_stack.push_back(n.right);
+					m_stack.push_back(n.left);
+				}
+				else
+				{
+					m_stack.push_back(n.left);
+					m_stack.push_back(n.right);
+				}
+			}
+			else if (t_left >= 0.0f)
+				m_stack.push_back(n.left);
+			else if (t_right >= 0.0f)
+				m_stack.push_back(n.right);
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void BVH::clear()
+	{
+		m_nodes.clear();
+		m_free_nodes.clear();
+		m_objects.clear();
+		m_free_objects.clear();
+		m_root = BVH_NULL;
+		m_object_count = 0;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	uint32_t BVH::allocate_node()
+	{
+		uint32_t node;
+
+		if (m_free_nodes.empty())
+		{
+			node = uint32_t(m_nodes.size());
+			m_nodes.push_back(Node());
+		}
+		else
+		{
+			node = m_free_nodes.back();
+			m_free_nodes.pop_back();
+		}
+
+		m_nodes[node].parent = BVH_NULL;
+		m_nodes[node].left = BVH_NULL;
+		m_nodes[node].right = BVH_NULL;
+		m_nodes[node].object = BVH_NULL;
+
+		return node;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void BVH::free_node(uint32_t node)
+	{
+		m_free_nodes.push_back(node);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void BVH::insert_leaf(uint32_t leaf)
+	{
+		if (m_root == BVH_NULL)
+		{
+			m_root = leaf;
+			return;
+		}
+
+		AABB	 aabb = m_nodes[leaf].aabb;
+		uint32_t	node = m_root;
+
+		// Descend towards the child whose surface area grows the least, stopping when pairing with the current node
+		// is cheaper than pushing the leaf further down.
+		while (m_nodes[node].object == BVH_NULL)
+		{
+			const Node& n = m_nodes[node];
+
+			float area = surface_area(n.aabb);
+			float combined_area = surface_area(merge(n.aabb, aabb));
+			float cost = 2.0f * combined_area;
+			float inheritance_cost = 2.0f * (combined_area - area);
+
+			float cost_left = surface_area(merge(m_nodes[n.left].aabb, aabb)) + inheritance_cost;
+			float cost_right = surface_area(merge(m_nodes[n.right].aabb, aabb)) + inheritance_cost;
+
+			if (m_nodes[n.left].object == BVH_NULL)
+				cost_left -= surface_area(m_nodes[n.left].aabb);
+
+			if (m_nodes[n.right].object == BVH_NULL)
+				cost_right -= surface_area(m_nodes[n.right].aabb);
+
+			if (cost < cost_left && cost < cost_right)
+				break;
+
+			node = cost_left < cost_right ? n.left : n.right;
+		}
+
+		uint32_t sibling = node;
+		uint32_t old_parent = m_nodes[sibling].parent;
+		uint32_t new_parent = allocate_node();
+
+		m_nodes[new_parent].parent = old_parent;
+		m_nodes[new_parent].aabb = merge(aabb, m_nodes[sibling].aabb);
+		m_nodes[new_parent].left = sibling;
+		m_nodes[new_parent].right = leaf;
+		m_nodes[sibling].parent = new_parent;
+		m_nodes[leaf].parent = new_parent;
+
+		if (old_parent == BVH_NULL)
+			m_root = new_parent;
+		else if (m_nodes[old_parent].left == sibling)
+			m_nodes[old_parent].left = new_parent;
+		else
+			m_nodes[old_parent].right = new_parent;
+
+		refit_ancestors(old_parent);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void BVH::remove_leaf(uint32_t leaf)
+	{
+		if (leaf == m_root)
+		{
+			m_root = BVH_NULL;
+			return;
+		}
+
+		uint32_t parent = m_nodes[leaf].parent;
+		uint32_t grand_parent = m_nodes[parent].parent;
+		uint32_t sibling = m_nodes[parent].left == leaf ? m_nodes[parent].right : m_nodes[parent].left;
+
+		// The sibling takes the parent's place.
+		if (grand_parent == BVH_NULL)
+		{
+			m_root = sibling;
+			m_nodes[sibling].parent = BVH_NULL;
+		}
+		else
+		{
+			if (m_nodes[grand_parent].left == parent)
+				m_nodes[grand_parent].left = sibling;
+			else
+				m_nodes[grand_parent].right = sibling;
+
+			m_nodes[sibling].parent = grand_parent;
+
+			refit_ancestors(grand_parent);
+		}
+
+		free_node(parent);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void BVH::refit_ancestors(uint32_t node)
+	{
+		while (node != BVH_NULL)
+		{
+			Node& n = m_nodes[node];
+
+			n.aabb = merge(m_nodes[n.left].aabb, m_nodes[n.right].aabb);
+			node = n.parent;
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	uint32_t BVH::build_recursive(uint32_t* objects, uint32_t count, uint32_t parent)
+	{
+		uint32_t node = allocate_node();
+
+		m_nodes[node].parent = parent;
+
+		if (count == 1)
+		{
+			m_nodes[node].aabb = m_objects[objects[0]].aabb;
+			m_nodes[node].object = objects[0];
+			m_objects[objects[0]].leaf = node;
+
+			return node;
+		}
+
+		AABB bounds = empty_aabb();
+		AABB centroid_bounds = empty_aabb();
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const AABB& aabb = m_objects[objects[i]].aabb;
+			glm::vec3	centroid = (aabb.min + aabb.max) * 0.5f;
+
+			bounds = merge(bounds, aabb);
+			centroid_bounds.min = glm::min(centroid_bounds.min, centroid);
+			centroid_bounds.max = glm::max(centroid_bounds.max, centroid);
+		}
+
+		m_nodes[node].aabb = bounds;
+
+		// Split along the axis with the largest centroid spread.
+		glm::vec3 extent = centroid_bounds.max - centroid_bounds.min;
+		int		  axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+		uint32_t  mid = count / 2;
+
+		if (extent[axis] > 0.0f)
+		{
+			AABB	 bins[BVH_SAH_BINS];
+			uint32_t bin_counts[BVH_SAH_BINS] = {};
+			float	 scale = BVH_SAH_BINS / extent[axis];
+
+			for (int i = 0; i < BVH_SAH_BINS; i++)
+				bins[i] = empty_aabb();
+
+			auto bin_index = [&](uint32_t object) {
+				const AABB& aabb = m_objects[object].aabb;
+				float		centroid = (aabb.min[axis] + aabb.max[axis]) * 0.5f;
+				return std::min(int((centroid - centroid_bounds.min[axis]) * scale), BVH_SAH_BINS - 1);
+			};
+
+			for (uint32_t i = 0; i < count; i++)
+			{
+				int bin = bin_index(objects[i]);
+				bins[bin] = merge(bins[bin], m_objects[objects[i]].aabb);
+				bin_counts[bin]++;
+			}
+
+			// Sweep from the right to get the cost of every right partition, then from the left to evaluate each split.
+			float	 right_cost[BVH_SAH_BINS];
+			AABB	 right_bounds = empty_aabb();
+			uint32_t right_count = 0;
+
+			for (int i = BVH_SAH_BINS - 1; i > 0; i--)
+			{
+				right_bounds = merge(right_bounds, bins[i]);
+				right_count += bin_counts[i];
+				right_cost[i] = right_count > 0 ? surface_area(right_bounds) * right_count : 0.0f;
+			}
+
+			AABB	 left_bounds = empty_aabb();
+			uint32_t left_count = 0;
+			float	 best_cost = FLT_MAX;
+			int		 best_split = -1;
+
+			for (int i = 0; i < BVH_SAH_BINS - 1; i++)
+			{
+				left_bounds = merge(left_bounds, bins[i]);
+				left_count += bin_counts[i];
+
+				if (left_count == 0 || left_count == count)
+					continue;
+
+				float cost = surface_area(left_bounds) * left_count + right_cost[i + 1];
+
+				if (cost < best_cost)
+				{
+					best_cost = cost;
+					best_split = i;
+				}
+			}
+
+			if (best_split >= 0)
+			{
+				uint32_t* split = std::partition(objects, objects + count, [&](uint32_t object) { return bin_index(object) <= best_split; });
+				mid = uint32_t(split - objects);
+			}
+		}
+
+		// Depth-first layout: the left subtree is allocated right after this node.
+		uint32_t left = build_recursive(objects, mid, node);
+		uint32_t right = build_recursive(objects + mid, count - mid, node);
+
+		m_nodes[node].left = left;
+		m_nodes[node].right = right;
+
+		return node;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void BVH::collect(uint32_t node, std::vector<uint32_t>& objects)
+	{
+		size_t base = m_stack.size();
+
+		m_stack.push_back(node);
+
+		while (m_stack.size() > base)
+		{
+			uint32_t	current = m_stack.back();
+			const Node& n = m_nodes[current];
+
+			m_stack.pop_back();
+
+			if (n.object != BVH_NULL)
+				objects.push_back(n.object);
+			else
+			{
+				m_stack.push_back(n.right);
+				m_stack.push_back(n.left);
+			}
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+} // namespace dw
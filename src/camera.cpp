@@ -97,52 +97,34 @@ namespace dw
 
 	bool Camera::aabb_inside_frustum(glm::vec3 max_v, glm::vec3 min_v)
 	{
-		//m_model = glm::mat3(m_right, m_up, m_forward);
+		for (int i = 0; i < 6; i++)
+		{
+			if (!aabb_inside_plane(m_frustum.planes[i], max_v, min_v))
+				return false;
+		}
 
-		//m_near_plane.point = m_position - m_forward * m_near;
-		//if (!aabb_inside_plane(m_near_plane, max_v, min_v))
-		//	return false;
-
-		//m_far_plane.point = m_position - m_forward * m_far;
-		//if (!aabb_inside_plane(m_far_plane, max_v, min_v))
-		//	return false;
-
-		//m_left_plane.point = m_position;
-		//if (!aabb_inside_plane(m_left_plane, max_v, min_v))
-		//	return false;
+		return true;
+	}
 
-		//m_right_plane.point = m_position;
-		//if (!aabb_inside_plane(m_right_plane, max_v, min_v))
-		//	return false;
+	bool Camera::aabb_inside_frustum(glm::vec3 max_v, glm::vec3 min_v, uint32_t& plane_mask, uint32_t& last_plane)
+	{
+		// Static objects tend to be rejected by the same plane frame after frame, so that plane is tried first.
+		if (last_plane < 6 && (plane_mask & (1 << last_plane)) && !aabb_inside_plane(m_frustum.planes[last_plane], max_v, min_v))
+			return false;
 
-		//m_top_plane.point = m_position;
-		//if (!aabb_inside_plane(m_top_plane, max_v, min_v))
-		//	return false;
+		AABB aabb;
 
-		//m_bottom_plane.point = m_position;
-		//if (!aabb_inside_plane(m_bottom_plane, max_v, min_v))
-		//	return false;
+		aabb.min = min_v;
+		aabb.max = max_v;
 
-		return true;
+		return intersects(m_frustum, aabb, plane_mask, &last_plane);
 	}
 
 	bool Camera::aabb_inside_plane(Plane plane, glm::vec3 max_v, glm::vec3 min_v)
 	{
-		//plane.normal = m_model * plane.normal;
-
-		//glm::vec3 p = min_v;
-
-		//if (plane.normal.x >= 0)
-		//	p.x = max_v.x;
-		//if (plane.normal.y >= 0)
-		//	p.y = max_v.y;
-		//if (plane.normal.z >= 0)
-		//	p.z = max_v.z;
-
-		//float dotProd = glm::dot(p - plane.point, plane.normal);
-		//if (dotProd < 0)
-		//	return false;
-		//else
-			return true;
+		// p-vertex test: only the corner furthest along the normal needs checking.
+		glm::vec3 p = glm::vec3(plane.n.x >= 0.0f ? max_v.x : min_v.x, plane.n.y >= 0.0f ? max_v.y : min_v.y, plane.n.z >= 0.0f ? max_v.z : min_v.z);
+
+		return glm::dot(plane.n, p) + plane.d >= 0.0f;
 	}
 } // namespace dw
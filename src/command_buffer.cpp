@@ -0,0 +1,386 @@
+#include <command_buffer.h>
+#include <logger.h>
+#include <string.h>
+
+namespace dw
+{
+	// Every command starts with a header holding its type and total size, so the stream can be walked linearly.
+	struct CommandHeader
+	{
+		uint32_t type;
+		uint32_t size;
+	};
+
+	struct CmdBindProgram					{ CommandHeader header; Program* program; };
+	struct CmdBindVertexArray				{ CommandHeader header; VertexArray* vao; };
+	struct CmdBindTexture					{ CommandHeader header; Texture* texture; uint32_t unit; };
+	struct CmdBindBufferBase				{ CommandHeader header; Buffer* buffer; uint32_t index; };
+	struct CmdBindBufferRange				{ CommandHeader header; Buffer* buffer; uint32_t index; size_t offset; size_t size; };
+	struct CmdBindFramebuffer				{ CommandHeader header; Framebuffer* fbo; };
+	struct CmdUpdateBuffer					{ CommandHeader header; Buffer* buffer; size_t offset; size_t size; };
+	struct CmdViewport						{ CommandHeader header; int32_t x, y, w, h; };
+	struct CmdClear							{ CommandHeader header; GLbitfield mask; float color[4]; float depth; };
+	struct CmdState							{ CommandHeader header; GLenum cap; };
+	struct CmdBlendFunc						{ CommandHeader header; GLenum src; GLenum dst; };
+	struct CmdDrawArrays					{ CommandHeader header; GLenum mode; int32_t first; int32_t count; int32_t instance_count; };
+	struct CmdDrawElements					{ CommandHeader header; GLenum mode; int32_t count; GLenum type; size_t offset; int32_t instance_count; int32_t base_vertex; };
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	CommandBuffer::CommandBuffer(size_t initial_capacity)
+	{
+		m_stream.reserve(initial_capacity);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	CommandBuffer::~CommandBuffer() {}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	template<typename T>
+	T* CommandBuffer::push(CommandType type, size_t payload)
+	{
+		size_t size = ((sizeof(T) + payload + 7) / 8) * 8;
+		size_t offset = m_stream.size();
+
+		m_stream.resize(offset + size);
+
+		T* cmd = reinterpret_cast<T*>(&m_stream[offset]);
+
+		cmd->header.type = type;
+		cmd->header.size = size;
+
+		m_command_count++;
+
+		return cmd;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void CommandBuffer::bind_program(Program* program)
+	{
+		push<CmdBindProgram>(COMMAND_BIND_PROGRAM)->program = program;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void CommandBuffer::bind_vertex_array(VertexArray* vao)
+	{
+		push<CmdBindVertexArray>(COMMAND_BIND_VERTEX_ARRAY)->vao = vao;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void CommandBuffer::bind_texture(Texture* texture, uint32_t unit)
+	{
+		CmdBindTexture* cmd = push<CmdBindTexture>(COMMAND_BIND_TEXTURE);
+
+		cmd->texture = texture;
+		cmd->unit = unit;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void CommandBuffer::bind_buffer_base(Buffer* buffer, uint32_t index)
+	{
+		CmdBindBufferBase* cmd = push<CmdBindBufferBase>(COMMAND_BIND_BUFFER_BASE);
+
+		cmd->buffer = buffer;
+		cmd->index = index;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void CommandBuffer::bind_buffer_range(Buffer* buffer, uint32_t index, size_t offset, size_t size)
+	{
+		CmdBindBufferRange* cmd = push<CmdBindBufferRange>(COMMAND_BIND_BUFFER_RANGE);
+
+		cmd->buffer = buffer;
+		cmd->index = index;
+		cmd->offset = offset;
+		cmd->size = size;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void CommandBuffer::bind_framebuffer(Framebuffer* fbo)
+	{
+		push<CmdBindFramebuffer>(COMMAND_BIND_FRAMEBUFFER)->fbo = fbo;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void CommandBuffer::update_buffer(Buffer* buffer, size_t offset, size_t size, const void* data)
+	{
+		CmdUpdateBuffer* cmd = push<CmdUpdateBuffer>(COMMAND_UPDATE_BUFFER, size);
+
+		cmd->buffer = buffer;
+		cmd->offset = offset;
+		cmd->size = size;
+
+		// Payload directly follows the command.
+		memcpy(cmd + 1, data, size);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void CommandBuffer::viewport(int32_t x, int32_t y, int32_t w, int32_t h)
+	{
+		CmdViewport* cmd = push<CmdViewport>(COMMAND_VIEWPORT);
+
+		cmd->x = x;
+		cmd->y = y;
+		cmd->w = w;
+		cmd->h = h;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void CommandBuffer::clear(GLbitfield mask, float r, float g, float b, float a, float depth)
+	{
+		CmdClear* cmd = push<CmdClear>(COMMAND_CLEAR);
+
+		cmd->mask = mask;
+		cmd->color[0] = r;
+		cmd->color[1] = g;
+		cmd->color[2] = b;
+		cmd->color[3] = a;
+		cmd->depth = depth;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void CommandBuffer::enable(GLenum cap)
+	{
+		push<CmdState>(COMMAND_ENABLE)->cap = cap;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void CommandBuffer::disable(GLenum cap)
+	{
+		push<CmdState>(COMMAND_DISABLE)->cap = cap;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void CommandBuffer::depth_func(GLenum func)
+	{
+		push<CmdState>(COMMAND_DEPTH_FUNC)->cap = func;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void CommandBuffer::blend_func(GLenum src, GLenum dst)
+	{
+		CmdBlendFunc* cmd = push<CmdBlendFunc>(COMMAND_BLEND_FUNC);
+
+		cmd->src = src;
+		cmd->dst = dst;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void CommandBuffer::cull_face(GLenum mode)
+	{
+		push<CmdState>(COMMAND_CULL_FACE)->cap = mode;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void CommandBuffer::draw_arrays(GLenum mode, int32_t first, int32_t count)
+	{
+		draw_arrays_instanced(mode, first, count, 1);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void CommandBuffer::draw_arrays_instanced(GLenum mode, int32_t first, int32_t count, int32_t instance_count)
+	{
+		CmdDrawArrays* cmd = push<CmdDrawArrays>(instance_count == 1 ? COMMAND_DRAW_ARRAYS : COMMAND_DRAW_ARRAYS_INSTANCED);
+
+		cmd->mode = mode;
+		cmd->first = first;
+		cmd->count = count;
+		cmd->instance_count = instance_count;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void CommandBuffer::draw_elements_base_vertex(GLenum mode, int32_t count, GLenum type, size_t offset, int32_t base_vertex)
+	{
+		draw_elements_instanced_base_vertex(mode, count, type, offset, 1, base_vertex);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void CommandBuffer::draw_elements_instanced_base_vertex(GLenum mode, int32_t count, GLenum type, size_t offset, int32_t instance_count, int32_t base_vertex)
+	{
+		CmdDrawElements* cmd = push<CmdDrawElements>(instance_count == 1 ? COMMAND_DRAW_ELEMENTS_BASE_VERTEX : COMMAND_DRAW_ELEMENTS_INSTANCED_BASE_VERTEX);
+
+		cmd->mode = mode;
+		cmd->count = count;
+		cmd->type = type;
+		cmd->offset = offset;
+		cmd->instance_count = instance_count;
+		cmd->base_vertex = base_vertex;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void CommandBuffer::execute()
+	{
+		size_t pos = 0;
+
+		while (pos < m_stream.size())
+		{
+			const uint8_t* ptr = &m_stream[pos];
+			const CommandHeader* header = reinterpret_cast<const CommandHeader*>(ptr);
+
+			switch (header->type)
+			{
+				case COMMAND_BIND_PROGRAM:
+				{
+					reinterpret_cast<const CmdBindProgram*>(ptr)->program->use();
+					break;
+				}
+				case COMMAND_BIND_VERTEX_ARRAY:
+				{
+					reinterpret_cast<const CmdBindVertexArray*>(ptr)->vao->bind();
+					break;
+				}
+				case COMMAND_BIND_TEXTURE:
+				{
+					const CmdBindTexture* cmd = reinterpret_cast<const CmdBindTexture*>(ptr);
+					cmd->texture->bind(cmd->unit);
+					break;
+				}
+				case COMMAND_BIND_BUFFER_BASE:
+				{
+					const CmdBindBufferBase* cmd = reinterpret_cast<const CmdBindBufferBase*>(ptr);
+					cmd->buffer->bind_base(cmd->index);
+					break;
+				}
+				case COMMAND_BIND_BUFFER_RANGE:
+				{
+					const CmdBindBufferRange* cmd = reinterpret_cast<const CmdBindBufferRange*>(ptr);
+					cmd->buffer->bind_range(cmd->index, cmd->offset, cmd->size);
+					break;
+				}
+				case COMMAND_BIND_FRAMEBUFFER:
+				{
+					const CmdBindFramebuffer* cmd = reinterpret_cast<const CmdBindFramebuffer*>(ptr);
+
+					if (cmd->fbo)
+						cmd->fbo->bind();
+					else
+					{
+						GL_CHECK_ERROR(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+					}
+					break;
+				}
+				case COMMAND_UPDATE_BUFFER:
+				{
+					const CmdUpdateBuffer* cmd = reinterpret_cast<const CmdUpdateBuffer*>(ptr);
+					cmd->buffer->set_data(cmd->offset, cmd->size, (void*)(cmd + 1));
+					break;
+				}
+				case COMMAND_VIEWPORT:
+				{
+					const CmdViewport* cmd = reinterpret_cast<const CmdViewport*>(ptr);
+					GL_CHECK_ERROR(glViewport(cmd->x, cmd->y, cmd->w, cmd->h));
+					break;
+				}
+				case COMMAND_CLEAR:
+				{
+					const CmdClear* cmd = reinterpret_cast<const CmdClear*>(ptr);
+
+					if (cmd->mask & GL_COLOR_BUFFER_BIT)
+					{
+						GL_CHECK_ERROR(glClearColor(cmd->color[0], cmd->color[1], cmd->color[2], cmd->color[3]));
+					}
+
+					if (cmd->mask & GL_DEPTH_BUFFER_BIT)
+					{
+#if defined(__EMSCRIPTEN__)
+						GL_CHECK_ERROR(glClearDepthf(cmd->depth));
+#else
+						GL_CHECK_ERROR(glClearDepth(cmd->depth));
+#endif
+					}
+
+					GL_CHECK_ERROR(glClear(cmd->mask));
+					break;
+				}
+				case COMMAND_ENABLE:
+				{
+					GL_CHECK_ERROR(glEnable(reinterpret_cast<const CmdState*>(ptr)->cap));
+					break;
+				}
+				case COMMAND_DISABLE:
+				{
+					GL_CHECK_ERROR(glDisable(reinterpret_cast<const CmdState*>(ptr)->cap));
+					break;
+				}
+				case COMMAND_DEPTH_FUNC:
+				{
+					GL_CHECK_ERROR(glDepthFunc(reinterpret_cast<const CmdState*>(ptr)->cap));
+					break;
+				}
+				case COMMAND_BLEND_FUNC:
+				{
+					const CmdBlendFunc* cmd = reinterpret_cast<const CmdBlendFunc*>(ptr);
+					GL_CHECK_ERROR(glBlendFunc(cmd->src, cmd->dst));
+					break;
+				}
+				case COMMAND_CULL_FACE:
+				{
+					GL_CHECK_ERROR(glCullFace(reinterpret_cast<const CmdState*>(ptr)->cap));
+					break;
+				}
+				case COMMAND_DRAW_ARRAYS:
+				{
+					const CmdDrawArrays* cmd = reinterpret_cast<const CmdDrawArrays*>(ptr);
+					GL_CHECK_ERROR(glDrawArrays(cmd->mode, cmd->first, cmd->count));
+					break;
+				}
+				case COMMAND_DRAW_ARRAYS_INSTANCED:
+				{
+					const CmdDrawArrays* cmd = reinterpret_cast<const CmdDrawArrays*>(ptr);
+					GL_CHECK_ERROR(glDrawArraysInstanced(cmd->mode, cmd->first, cmd->count, cmd->instance_count));
+					break;
+				}
+				case COMMAND_DRAW_ELEMENTS_BASE_VERTEX:
+				{
+					const CmdDrawElements* cmd = reinterpret_cast<const CmdDrawElements*>(ptr);
+					GL_CHECK_ERROR(glDrawElementsBaseVertex(cmd->mode, cmd->count, cmd->type, (void*)cmd->offset, cmd->base_vertex));
+					break;
+				}
+				case COMMAND_DRAW_ELEMENTS_INSTANCED_BASE_VERTEX:
+				{
+					const CmdDrawElements* cmd = reinterpret_cast<const CmdDrawElements*>(ptr);
+					GL_CHECK_ERROR(glDrawElementsInstancedBaseVertex(cmd->mode, cmd->count, cmd->type, (void*)cmd->offset, cmd->instance_count, cmd->base_vertex));
+					break;
+				}
+				default:
+				{
+					DW_LOG_ERROR("CommandBuffer: Unknown command type " + std::to_string(header->type));
+					return;
+				}
+			}
+
+			pos += header->size;
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void CommandBuffer::reset()
+	{
+		m_stream.clear();
+		m_command_count = 0;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+} // namespace dw
@@ -55,6 +55,15 @@ namespace dw
 
 	bool DebugDraw::init()
 	{
+		return init(&m_default_binder);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	bool DebugDraw::init(PipelineStateBinder* binder)
+	{
+		m_binder = binder;
+
 		// Create shaders
 		m_line_vs = std::make_unique<Shader>(GL_VERTEX_SHADER, g_vs_src);
 		m_line_fs = std::make_unique<Shader>(GL_FRAGMENT_SHADER, g_fs_src);
@@ -69,11 +78,9 @@ namespace dw
 		Shader* shaders[] = { m_line_vs.get(), m_line_fs.get() };
 		m_line_program = std::make_unique<Program>(2, shaders);
 
-		// Bind uniform block index
-		m_line_program->uniform_block_binding("CameraUniforms", 0);
-
 		// Create vertex buffer
-		m_line_vbo = std::make_unique<VertexBuffer>(GL_DYNAMIC_DRAW, sizeof(VertexWorld) * MAX_VERTICES);
+		// One extra vertex leaves room to align each frame's allocation to the vertex size.
+		m_line_vbo = std::make_unique<StreamBuffer>(GL_ARRAY_BUFFER, sizeof(VertexWorld) * (MAX_VERTICES + 1));
 
 		// Declare vertex attributes
 		VertexAttrib attribs[] =
@@ -93,7 +100,17 @@ namespace dw
 		}
 
 		// Create uniform buffer for matrix data
-		m_ubo = std::make_unique<UniformBuffer>(GL_DYNAMIC_DRAW, sizeof(CameraUniforms));
+		m_ubo = std::make_unique<StreamBuffer>(GL_UNIFORM_BUFFER, sizeof(CameraUniforms));
+
+		// Lines are drawn on top of everything, from both sides.
+		PipelineStateDesc pso_desc;
+
+		pso_desc.program = m_line_program.get();
+		pso_desc.vertex_array = m_line_vao.get();
+		pso_desc.depth.test = false;
+		pso_desc.cull.enable = false;
+
+		m_pso = std::make_unique<PipelineState>(pso_desc);
 
 		return true;
 	}
@@ -450,35 +467,37 @@ namespace dw
 		{
 			m_uniforms.view_proj = view_proj;
 
-			#if defined(__EMSCRIPTEN__)
-			void* ptr = m_line_vbo->map(0);
-			#else
-			void* ptr = m_line_vbo->map(GL_WRITE_ONLY);
-			#endif
-			
+			m_line_vbo->begin_frame();
+			m_ubo->begin_frame();
+
+			size_t vbo_offset = 0;
+			size_t ubo_offset = 0;
+
+			void* vertices = nullptr;
+
 			if (m_world_vertices.size() > MAX_VERTICES)
 				DW_LOG_ERROR("Vertex count above allowed limit!");
 			else
-				memcpy(ptr, &m_world_vertices[0], sizeof(VertexWorld) * m_world_vertices.size());
+				vertices = m_line_vbo->allocate(sizeof(VertexWorld) * m_world_vertices.size(), sizeof(VertexWorld), vbo_offset);
 
-			m_line_vbo->unmap();
+			void* uniforms = m_ubo->allocate(sizeof(CameraUniforms), 1, ubo_offset);
 
-			#if defined(__EMSCRIPTEN__)
-			ptr = m_ubo->map(0);
-			#else
-			ptr = m_ubo->map(GL_WRITE_ONLY);
-			#endif
+			// Nothing is drawn this frame if either buffer is out of space.
+			if (!vertices || !uniforms)
+			{
+				m_line_vbo->end_frame();
+				m_ubo->end_frame();
 
-			memcpy(ptr, &m_uniforms, sizeof(CameraUniforms));
-			m_ubo->unmap();
+				m_draw_commands.clear();
+				m_world_vertices.clear();
+				return;
+			}
 
-			// Get previous state
-			GLboolean last_enable_cull_face = glIsEnabled(GL_CULL_FACE);
-			GLboolean last_enable_depth_test = glIsEnabled(GL_DEPTH_TEST);
+			memcpy(vertices, &m_world_vertices[0], sizeof(VertexWorld) * m_world_vertices.size());
+			memcpy(uniforms, &m_uniforms, sizeof(CameraUniforms));
 
-			// Set initial state
-			glDisable(GL_DEPTH_TEST);
-			glDisable(GL_CULL_FACE);
+			m_line_vbo->flush();
+			m_ubo->flush();
 
 			if (fbo)
 				fbo->bind();
@@ -486,11 +505,13 @@ namespace dw
 				glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
 			glViewport(0, 0, width, height);
-			m_line_program->use();
-			m_ubo->bind_base(0);
-			m_line_vao->bind();
 
-			int v = 0;
+			// Only the state that differs from the caller's pipeline is changed. The caller's next bind restores it.
+			m_binder->bind(m_pso.get());
+			m_ubo->bind_range(0, ubo_offset, sizeof(CameraUniforms));
+
+			// Vertices are drawn relative to this frame's allocation.
+			int v = vbo_offset / sizeof(VertexWorld);
 
 			for (int i = 0; i < m_draw_commands.size(); i++)
 			{
@@ -499,15 +520,11 @@ namespace dw
 				v += cmd.vertices;
 			}
 
+			m_line_vbo->end_frame();
+			m_ubo->end_frame();
+
 			m_draw_commands.clear();
 			m_world_vertices.clear();
-
-			// Restore state
-			if (last_enable_cull_face)
-				glEnable(GL_CULL_FACE);
-
-			if (last_enable_depth_test)
-				glEnable(GL_DEPTH_TEST);
 		}
 	}
 
@@ -0,0 +1,270 @@
+#include <frame_recorder.h>
+#include <logger.h>
+#include <algorithm>
+#include <string.h>
+
+#if !defined(__EMSCRIPTEN__)
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+#endif
+
+namespace dw
+{
+#if !defined(__EMSCRIPTEN__)
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	FrameRecorder::FrameRecorder() {}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	FrameRecorder::~FrameRecorder()
+	{
+		stop();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	bool FrameRecorder::start(const std::string& path, FrameRecorderFormat format, uint32_t width, uint32_t height, uint32_t fps, uint32_t num_workers, uint32_t max_queued_frames, uint64_t first_frame)
+	{
+		if (m_recording)
+			stop();
+
+		m_path = path;
+		m_format = format;
+		m_width = width;
+		m_height = height;
+		m_max_queued_frames = std::max(max_queued_frames, 1u);
+		m_frames_written = 0;
+		m_first_frame = first_frame;
+		m_next_write = 0;
+		m_quit = false;
+
+		if (format == FRAME_RECORDER_FORMAT_Y4M)
+		{
+			m_y4m_file = fopen(path.c_str(), "wb");
+
+			if (!m_y4m_file)
+			{
+				DW_LOG_ERROR("FrameRecorder: Failed to open " + path);
+				return false;
+			}
+
+			// C420jpeg: full range BT.601 with chroma sited between samples, matching the conversion in write_y4m().
+			fprintf(m_y4m_file, "YUV4MPEG2 W%u H%u F%u:1 Ip A1:1 C420jpeg\n", width, height, fps);
+		}
+
+		if (num_workers == 0)
+			num_workers = std::max(std::thread::hardware_concurrency(), 1u);
+
+		for (uint32_t i = 0; i < num_workers; i++)
+			m_workers.push_back(std::thread(&FrameRecorder::worker, this));
+
+		m_readback = std::make_unique<FramebufferReadback>();
+		m_recording = true;
+
+		DW_LOG_INFO("FrameRecorder: Recording to " + path + " with " + std::to_string(num_workers) + " workers");
+
+		return true;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void FrameRecorder::capture(Framebuffer* fbo, uint32_t width, uint32_t height)
+	{
+		if (!m_recording)
+			return;
+
+		// Never read outside the framebuffer. enqueue() pads smaller frames back to the recorded size.
+		width = width == 0 ? m_width : std::min(width, m_width);
+		height = height == 0 ? m_height : std::min(height, m_height);
+
+		m_readback->read(fbo, 0, 0, 0, width, height, [this](const void* pixels, uint32_t width, uint32_t height, uint64_t id) {
+			enqueue(pixels, width, height, id);
+		});
+
+		m_readback->poll();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void FrameRecorder::stop()
+	{
+		if (!m_recording)
+			return;
+
+		m_readback->flush();
+		m_readback.reset();
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_quit = true;
+		}
+
+		m_job_cv.notify_all();
+
+		for (auto& worker : m_workers)
+			worker.join();
+
+		m_workers.clear();
+
+		if (m_y4m_file)
+		{
+			fclose(m_y4m_file);
+			m_y4m_file = nullptr;
+		}
+
+		m_recording = false;
+
+		DW_LOG_INFO("FrameRecorder: Wrote " + std::to_string(m_frames_written) + " frames");
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void FrameRecorder::enqueue(const void* pixels, uint32_t width, uint32_t height, uint64_t frame)
+	{
+		Job job;
+
+		job.frame = frame;
+
+		job.pixels.resize(size_t(m_width) * m_height * 4);
+
+		// Frames captured after the framebuffer shrank are placed top-left on an opaque black frame of the recorded size.
+		if (width < m_width || height < m_height)
+		{
+			for (size_t i = 0; i < job.pixels.size(); i += 4)
+			{
+				job.pixels[i] = job.pixels[i + 1] = job.pixels[i + 2] = 0;
+				job.pixels[i + 3] = 255;
+			}
+		}
+
+		// Copy out of the mapped buffer right away so it can be reused, flipping to top row first on the way.
+		size_t src_row_size = size_t(width) * 4;
+		size_t dst_row_size = size_t(m_width) * 4;
+
+		for (uint32_t y = 0; y < height; y++)
+			memcpy(&job.pixels[y * dst_row_size], static_cast<const uint8_t*>(pixels) + (height - 1 - y) * src_row_size, src_row_size);
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		// Backpressure: hold the render thread until the workers catch up.
+		m_space_cv.wait(lock, [this]() { return m_jobs.size() < m_max_queued_frames; });
+
+		m_jobs.push_back(std::move(job));
+
+		lock.unlock();
+		m_job_cv.notify_one();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void FrameRecorder::worker()
+	{
+		while (true)
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+
+			m_job_cv.wait(lock, [this]() { return m_quit || !m_jobs.empty(); });
+
+			if (m_jobs.empty())
+				return;
+
+			Job job = std::move(m_jobs.front());
+			m_jobs.pop_front();
+
+			lock.unlock();
+			m_space_cv.notify_one();
+
+			if (m_format == FRAME_RECORDER_FORMAT_PNG)
+				write_png(job);
+			else
+				write_y4m(job);
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void FrameRecorder::write_png(Job& job)
+	{
+		char suffix[32];
+		snprintf(suffix, sizeof(suffix), "_%06llu.png", (unsigned long long)(m_first_frame + job.frame));
+
+		std::string file = m_path + suffix;
+
+		if (!stbi_write_png(file.c_str(), m_width, m_height, 4, job.pixels.data(), m_width * 4))
+			DW_LOG_ERROR("FrameRecorder: Failed to write " + file);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_frames_written++;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void FrameRecorder::write_y4m(Job& job)
+	{
+		uint32_t chroma_w = (m_width + 1) / 2;
+		uint32_t chroma_h = (m_height + 1) / 2;
+
+		std::vector<uint8_t> yuv(size_t(m_width) * m_height + size_t(chroma_w) * chroma_h * 2);
+
+		uint8_t* y_plane = yuv.data();
+		uint8_t* u_plane = y_plane + size_t(m_width) * m_height;
+		uint8_t* v_plane = u_plane + size_t(chroma_w) * chroma_h;
+
+		const uint8_t* rgba = job.pixels.data();
+
+		// Full range BT.601. Conversion runs in parallel on the workers; only the write below is serialized.
+		for (uint32_t y = 0; y < m_height; y++)
+		{
+			for (uint32_t x = 0; x < m_width; x++)
+			{
+				const uint8_t* p = rgba + (size_t(y) * m_width + x) * 4;
+				y_plane[size_t(y) * m_width + x] = uint8_t((77 * p[0] + 150 * p[1] + 29 * p[2] + 128) >> 8);
+			}
+		}
+
+		for (uint32_t y = 0; y < chroma_h; y++)
+		{
+			for (uint32_t x = 0; x < chroma_w; x++)
+			{
+				int r = 0, g = 0, b = 0, n = 0;
+
+				for (uint32_t sy = y * 2; sy < std::min(y * 2 + 2, m_height); sy++)
+				{
+					for (uint32_t sx = x * 2; sx < std::min(x * 2 + 2, m_width); sx++)
+					{
+						const uint8_t* p = rgba + (size_t(sy) * m_width + sx) * 4;
+						r += p[0];
+						g += p[1];
+						b += p[2];
+						n++;
+					}
+				}
+
+				r /= n;
+				g /= n;
+				b /= n;
+
+				u_plane[size_t(y) * chroma_w + x] = uint8_t(std::min(std::max((-43 * r - 85 * g + 128 * b + 128) / 256 + 128, 0), 255));
+				v_plane[size_t(y) * chroma_w + x] = uint8_t(std::min(std::max((128 * r - 107 * g - 21 * b + 128) / 256 + 128, 0), 255));
+			}
+		}
+
+		// Frames must land in the stream in order, so wait for the previous frame to be written.
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		m_write_cv.wait(lock, [this, &job]() { return m_next_write == job.frame; });
+
+		fwrite("FRAME\n", 1, 6, m_y4m_file);
+		fwrite(yuv.data(), 1, yuv.size(), m_y4m_file);
+
+		m_next_write++;
+		m_frames_written++;
+
+		lock.unlock();
+		m_write_cv.notify_all();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+#endif
+} // namespace dw
@@ -0,0 +1,211 @@
+#include <framebuffer_readback.h>
+#include <logger.h>
+
+namespace dw
+{
+#if !defined(__EMSCRIPTEN__)
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	static size_t pixel_size(GLenum format, GLenum type)
+	{
+		size_t components = 4;
+
+		switch (format)
+		{
+			case GL_RED:
+			case GL_RED_INTEGER:
+			case GL_DEPTH_COMPONENT:
+				components = 1;
+				break;
+			case GL_RG:
+			case GL_RG_INTEGER:
+				components = 2;
+				break;
+			case GL_RGB:
+			case GL_BGR:
+			case GL_RGB_INTEGER:
+				components = 3;
+				break;
+			default:
+				break;
+		}
+
+		switch (type)
+		{
+			case GL_BYTE:
+			case GL_UNSIGNED_BYTE:
+				return components;
+			case GL_SHORT:
+			case GL_UNSIGNED_SHORT:
+			case GL_HALF_FLOAT:
+				return components * 2;
+			default:
+				return components * 4;
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	FramebufferReadback::FramebufferReadback(uint32_t num_buffers) : m_slots(num_buffers)
+	{
+		for (auto& slot : m_slots)
+		{
+			GL_CHECK_ERROR(glGenBuffers(1, &slot.pbo));
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	FramebufferReadback::~FramebufferReadback()
+	{
+		for (auto& slot : m_slots)
+		{
+			if (slot.fence)
+				glDeleteSync(slot.fence);
+
+			glDeleteBuffers(1, &slot.pbo);
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	uint64_t FramebufferReadback::read(Framebuffer* fbo, uint32_t attachment, int32_t x, int32_t y, uint32_t width, uint32_t height, Callback callback, GLenum format, GLenum type)
+	{
+		// Ring is full: the GPU is more than 'num_buffers' reads behind, so the oldest one has to be waited on.
+		if (m_pending == m_slots.size())
+		{
+			deliver(m_slots[m_tail], true);
+			m_tail = (m_tail + 1) % m_slots.size();
+			m_pending--;
+		}
+
+		Slot& slot = m_slots[m_head];
+
+		slot.width = width;
+		slot.height = height;
+		slot.size = pixel_size(format, type) * width * height;
+		slot.id = m_next_id++;
+		slot.callback = callback;
+
+		GL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo));
+
+		if (slot.size > slot.capacity)
+		{
+			GL_CHECK_ERROR(glBufferData(GL_PIXEL_PACK_BUFFER, slot.size, nullptr, GL_STREAM_READ));
+			slot.capacity = slot.size;
+		}
+
+		// The caller's read binding and the target's read buffer are restored after the read.
+		GLint last_read_fbo = 0;
+		GLint last_read_buffer = 0;
+
+		GL_CHECK_ERROR(glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &last_read_fbo));
+		GL_CHECK_ERROR(glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo ? fbo->id() : 0));
+		GL_CHECK_ERROR(glGetIntegerv(GL_READ_BUFFER, &last_read_buffer));
+
+		if (fbo)
+		{
+			GL_CHECK_ERROR(glReadBuffer(GL_COLOR_ATTACHMENT0 + attachment));
+		}
+		else
+		{
+			GL_CHECK_ERROR(glReadBuffer(GL_BACK));
+		}
+
+		// With a pack buffer bound the read is queued as a copy into the buffer instead of waiting for the GPU.
+		GL_CHECK_ERROR(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+		GL_CHECK_ERROR(glReadPixels(x, y, width, height, format, type, nullptr));
+		GL_CHECK_ERROR(glPixelStorei(GL_PACK_ALIGNMENT, 4));
+
+		GL_CHECK_ERROR(slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+		GL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+		GL_CHECK_ERROR(glReadBuffer(last_read_buffer));
+		GL_CHECK_ERROR(glBindFramebuffer(GL_READ_FRAMEBUFFER, last_read_fbo));
+
+		m_head = (m_head + 1) % m_slots.size();
+		m_pending++;
+
+		return slot.id;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void FramebufferReadback::poll()
+	{
+		while (m_pending > 0 && deliver(m_slots[m_tail], false))
+		{
+			m_tail = (m_tail + 1) % m_slots.size();
+			m_pending--;
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void FramebufferReadback::flush()
+	{
+		while (m_pending > 0)
+		{
+			deliver(m_slots[m_tail], true);
+			m_tail = (m_tail + 1) % m_slots.size();
+			m_pending--;
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	uint32_t FramebufferReadback::pending()
+	{
+		return m_pending;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	bool FramebufferReadback::deliver(Slot& slot, bool wait)
+	{
+		GLuint64 timeout = wait ? 1000000 : 0;
+
+		while (true)
+		{
+			// Flush on the first poll so the fence is guaranteed to signal eventually.
+			GL_CHECK_ERROR(GLenum result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout));
+
+			if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+				break;
+
+			if (result == GL_WAIT_FAILED)
+			{
+				DW_LOG_ERROR("OPENGL: glClientWaitSync failed on FramebufferReadback.");
+				break;
+			}
+
+			if (!wait)
+				return false;
+		}
+
+		glDeleteSync(slot.fence);
+		slot.fence = nullptr;
+
+		GL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo));
+		GL_CHECK_ERROR(void* ptr = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, slot.size, GL_MAP_READ_BIT));
+
+		if (ptr)
+		{
+			if (slot.callback)
+				slot.callback(ptr, slot.width, slot.height, slot.id);
+
+			GL_CHECK_ERROR(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+		}
+		else
+			DW_LOG_ERROR("OPENGL: Failed to map FramebufferReadback buffer.");
+
+		GL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+		slot.callback = nullptr;
+
+		return true;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+#endif
+} // namespace dw
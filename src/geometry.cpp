@@ -0,0 +1,264 @@
+#include <geometry.h>
+#include <simd.h>
+#include <worker_pool.h>
+#include <math.h>
+#include <algorithm>
+#include <thread>
+
+namespace dw
+{
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	// Number of threads worth using for 'count' boxes, capped by 'requested' (0 for one per hardware thread).
+	static uint32_t cull_thread_count(uint32_t requested, uint32_t count)
+	{
+		if (requested == 0)
+			requested = std::max(std::thread::hardware_concurrency(), 1u);
+
+		return std::min(requested, std::max(count / CULL_AABBS_MIN_BATCH_PER_THREAD, 1u));
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void cull_aabbs(const Frustum& frustum, const AABBArray& boxes, uint32_t first, uint32_t count, uint32_t* visibility)
+	{
+		float nx[6], ny[6], nz[6], ax[6], ay[6], az[6], d[6];
+
+		for (int p = 0; p < 6; p++)
+		{
+			nx[p] = frustum.planes[p].n.x;
+			ny[p] = frustum.planes[p].n.y;
+			nz[p] = frustum.planes[p].n.z;
+			ax[p] = fabsf(nx[p]);
+			ay[p] = fabsf(ny[p]);
+			az[p] = fabsf(nz[p]);
+			d[p] = frustum.planes[p].d;
+		}
+
+		uint32_t i = first;
+		uint32_t end = first + count;
+
+		// A box is outside if it lies entirely behind any plane: dot(n, c) + d + dot(|n|, e) < 0.
+#if defined(DW_SIMD_AVX)
+		for (; i + 32 <= end; i += 32)
+		{
+			uint32_t mask = 0;
+
+			for (uint32_t j = 0; j < 32; j += 8)
+			{
+				__m256 cx = _mm256_loadu_ps(boxes.center_x + i + j);
+				__m256 cy = _mm256_loadu_ps(boxes.center_y + i + j);
+				__m256 cz = _mm256_loadu_ps(boxes.center_z + i + j);
+				__m256 ex = _mm256_loadu_ps(boxes.extent_x + i + j);
+				__m256 ey = _mm256_loadu_ps(boxes.extent_y + i + j);
+				__m256 ez = _mm256_loadu_ps(boxes.extent_z + i + j);
+				__m256 outside = _mm256_setzero_ps();
+
+				for (int p = 0; p < 6; p++)
+				{
+					__m256 dist = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(cx, _mm256_set1_ps(nx[p])), _mm256_mul_ps(cy, _mm256_set1_ps(ny[p]))), _mm256_add_ps(_mm256_mul_ps(cz, _mm256_set1_ps(nz[p])), _mm256_set1_ps(d[p])));
+					__m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ex, _mm256_set1_ps(ax[p])), _mm256_mul_ps(ey, _mm256_set1_ps(ay[p]))), _mm256_mul_ps(ez, _mm256_set1_ps(az[p])));
+					outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(dist, radius), _mm256_setzero_ps(), _CMP_LT_OQ));
+				}
+
+				mask |= uint32_t(~_mm256_movemask_ps(outside) & 0xFF) << j;
+			}
+
+			visibility[i / 32] = mask;
+		}
+#elif defined(DW_SIMD_SSE)
+		for (; i + 32 <= end; i += 32)
+		{
+			uint32_t mask = 0;
+
+			for (uint32_t j = 0; j < 32; j += 4)
+			{
+				__m128 cx = _mm_loadu_ps(boxes.center_x + i + j);
+				__m128 cy = _mm_loadu_ps(boxes.center_y + i + j);
+				__m128 cz = _mm_loadu_ps(boxes.center_z + i + j);
+				__m128 ex = _mm_loadu_ps(boxes.extent_x + i + j);
+				__m128 ey = _mm_loadu_ps(boxes.extent_y + i + j);
+				__m128 ez = _mm_loadu_ps(boxes.extent_z + i + j);
+				__m128 outside = _mm_setzero_ps();
+
+				for (int p = 0; p < 6; p++)
+				{
+					__m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(nx[p])), _mm_mul_ps(cy, _mm_set1_ps(ny[p]))), _mm_add_ps(_mm_mul_ps(cz, _mm_set1_ps(nz[p])), _mm_set1_ps(d[p])));
+					__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, _mm_set1_ps(ax[p])), _mm_mul_ps(ey, _mm_set1_ps(ay[p]))), _mm_mul_ps(ez, _mm_set1_ps(az[p])));
+					outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(dist, radius), _mm_setzero_ps()));
+				}
+
+				mask |= uint32_t(~_mm_movemask_ps(outside) & 0xF) << j;
+			}
+
+			visibility[i / 32] = mask;
+		}
+#endif
+
+		for (; i < end; i += 32)
+		{
+			uint32_t mask = 0;
+			uint32_t word_end = std::min(i + 32, end);
+
+			for (uint32_t k = i; k < word_end; k++)
+			{
+				bool visible = true;
+
+				for (int p = 0; p < 6; p++)
+				{
+					float dist = boxes.center_x[k] * nx[p] + boxes.center_y[k] * ny[p] + boxes.center_z[k] * nz[p] + d[p];
+					float radius = boxes.extent_x[k] * ax[p] + boxes.extent_y[k] * ay[p] + boxes.extent_z[k] * az[p];
+
+					visible &= dist + radius >= 0.0f;
+				}
+
+				mask |= uint32_t(visible) << (k - i);
+			}
+
+			visibility[i / 32] = mask;
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void cull_aabbs_parallel(const Frustum& frustum, const AABBArray& boxes, uint32_t count, uint32_t* visibility, uint32_t num_threads)
+	{
+		uint32_t words = (count + 31) / 32;
+
+		num_threads = cull_thread_count(num_threads, count);
+
+		if (num_threads <= 1)
+		{
+			cull_aabbs(frustum, boxes, 0, count, visibility);
+			return;
+		}
+
+		uint32_t words_per_thread = (words + num_threads - 1) / num_threads;
+
+		WorkerPool::get().run(num_threads, [&](uint32_t t) {
+			uint32_t first = t * words_per_thread * 32;
+
+			if (first < count)
+				cull_aabbs(frustum, boxes, first, std::min(words_per_thread * 32, count - first), visibility);
+		});
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void cull_aabbs_multi(const Frustum* frustums, uint32_t frustum_count, const AABBArray& boxes, uint32_t first, uint32_t count, uint32_t* view_masks)
+	{
+		frustum_count = std::min(frustum_count, uint32_t(CULL_AABBS_MAX_FRUSTUMS));
+
+		// Planes in structure-of-arrays layout, eight lanes per frustum. The two padding lanes are zero, which is never
+		// outside.
+		alignas(32) float nx[CULL_AABBS_MAX_FRUSTUMS * 8] = {};
+		alignas(32) float ny[CULL_AABBS_MAX_FRUSTUMS * 8] = {};
+		alignas(32) float nz[CULL_AABBS_MAX_FRUSTUMS * 8] = {};
+		alignas(32) float ax[CULL_AABBS_MAX_FRUSTUMS * 8] = {};
+		alignas(32) float ay[CULL_AABBS_MAX_FRUSTUMS * 8] = {};
+		alignas(32) float az[CULL_AABBS_MAX_FRUSTUMS * 8] = {};
+		alignas(32) float d[CULL_AABBS_MAX_FRUSTUMS * 8] = {};
+
+		for (uint32_t f = 0; f < frustum_count; f++)
+		{
+			for (int p = 0; p < 6; p++)
+			{
+				const Plane& plane = frustums[f].planes[p];
+
+				nx[f * 8 + p] = plane.n.x;
+				ny[f * 8 + p] = plane.n.y;
+				nz[f * 8 + p] = plane.n.z;
+				ax[f * 8 + p] = fabsf(plane.n.x);
+				ay[f * 8 + p] = fabsf(plane.n.y);
+				az[f * 8 + p] = fabsf(plane.n.z);
+				d[f * 8 + p] = plane.d;
+			}
+		}
+
+		for (uint32_t i = first; i < first + count; i++)
+		{
+			uint32_t mask = 0;
+
+#if defined(DW_SIMD_AVX)
+			__m256 cx = _mm256_set1_ps(boxes.center_x[i]);
+			__m256 cy = _mm256_set1_ps(boxes.center_y[i]);
+			__m256 cz = _mm256_set1_ps(boxes.center_z[i]);
+			__m256 ex = _mm256_set1_ps(boxes.extent_x[i]);
+			__m256 ey = _mm256_set1_ps(boxes.extent_y[i]);
+			__m256 ez = _mm256_set1_ps(boxes.extent_z[i]);
+
+			for (uint32_t f = 0; f < frustum_count; f++)
+			{
+				uint32_t p = f * 8;
+
+				__m256 dist = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(cx, _mm256_load_ps(nx + p)), _mm256_mul_ps(cy, _mm256_load_ps(ny + p))), _mm256_add_ps(_mm256_mul_ps(cz, _mm256_load_ps(nz + p)), _mm256_load_ps(d + p)));
+				__m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ex, _mm256_load_ps(ax + p)), _mm256_mul_ps(ey, _mm256_load_ps(ay + p))), _mm256_mul_ps(ez, _mm256_load_ps(az + p)));
+
+				mask |= uint32_t(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_add_ps(dist, radius), _mm256_setzero_ps(), _CMP_LT_OQ)) == 0) << f;
+			}
+#elif defined(DW_SIMD_SSE)
+			__m128 cx = _mm_set1_ps(boxes.center_x[i]);
+			__m128 cy = _mm_set1_ps(boxes.center_y[i]);
+			__m128 cz = _mm_set1_ps(boxes.center_z[i]);
+			__m128 ex = _mm_set1_ps(boxes.extent_x[i]);
+			__m128 ey = _mm_set1_ps(boxes.extent_y[i]);
+			__m128 ez = _mm_set1_ps(boxes.extent_z[i]);
+
+			for (uint32_t f = 0; f < frustum_count; f++)
+			{
+				__m128 outside = _mm_setzero_ps();
+
+				for (uint32_t p = f * 8; p < f * 8 + 8; p += 4)
+				{
+					__m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, _mm_load_ps(nx + p)), _mm_mul_ps(cy, _mm_load_ps(ny + p))), _mm_add_ps(_mm_mul_ps(cz, _mm_load_ps(nz + p)), _mm_load_ps(d + p)));
+					__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, _mm_load_ps(ax + p)), _mm_mul_ps(ey, _mm_load_ps(ay + p))), _mm_mul_ps(ez, _mm_load_ps(az + p)));
+					outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(dist, radius), _mm_setzero_ps()));
+				}
+
+				mask |= uint32_t(_mm_movemask_ps(outside) == 0) << f;
+			}
+#else
+			for (uint32_t f = 0; f < frustum_count; f++)
+			{
+				bool visible = true;
+
+				for (uint32_t p = f * 8; p < f * 8 + 6; p++)
+				{
+					float dist = boxes.center_x[i] * nx[p] + boxes.center_y[i] * ny[p] + boxes.center_z[i] * nz[p] + d[p];
+					float radius = boxes.extent_x[i] * ax[p] + boxes.extent_y[i] * ay[p] + boxes.extent_z[i] * az[p];
+
+					visible &= dist + radius >= 0.0f;
+				}
+
+				mask |= uint32_t(visible) << f;
+			}
+#endif
+
+			view_masks[i] = mask;
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void cull_aabbs_multi_parallel(const Frustum* frustums, uint32_t frustum_count, const AABBArray& boxes, uint32_t count, uint32_t* view_masks, uint32_t num_threads)
+	{
+		num_threads = cull_thread_count(num_threads, count);
+
+		if (num_threads <= 1)
+		{
+			cull_aabbs_multi(frustums, frustum_count, boxes, 0, count, view_masks);
+			return;
+		}
+
+		uint32_t boxes_per_thread = (count + num_threads - 1) / num_threads;
+
+		WorkerPool::get().run(num_threads, [&](uint32_t t) {
+			uint32_t first = t * boxes_per_thread;
+
+			if (first < count)
+				cull_aabbs_multi(frustums, frustum_count, boxes, first, std::min(boxes_per_thread, count - first), view_masks);
+		});
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+} // namespace dw
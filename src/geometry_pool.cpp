@@ -0,0 +1,308 @@
+#include <geometry_pool.h>
+#include <logger.h>
+
+namespace dw
+{
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	RangeAllocator::RangeAllocator(uint32_t size)
+	{
+		reset(size);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	uint32_t RangeAllocator::allocate(uint32_t size)
+	{
+		if (size == 0)
+			return RANGE_ALLOCATOR_INVALID_OFFSET;
+
+		// Best fit: smallest free range that is large enough.
+		auto fit = m_free_by_size.lower_bound(size);
+
+		if (fit == m_free_by_size.end())
+			return RANGE_ALLOCATOR_INVALID_OFFSET;
+
+		uint32_t offset = fit->second;
+		uint32_t range_size = fit->first;
+
+		remove_free_range(m_free_by_offset.find(offset));
+
+		if (range_size > size)
+			insert_free_range(offset + size, range_size - size);
+
+		m_allocations[offset] = size;
+		m_free_space -= size;
+
+		return offset;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void RangeAllocator::free(uint32_t offset)
+	{
+		auto allocation = m_allocations.find(offset);
+
+		if (allocation == m_allocations.end())
+		{
+			DW_LOG_ERROR("RangeAllocator: Attempting to free unallocated offset " + std::to_string(offset));
+			return;
+		}
+
+		uint32_t size = allocation->second;
+		m_allocations.erase(allocation);
+		m_free_space += size;
+
+		// Coalesce with the following free range.
+		auto next = m_free_by_offset.find(offset + size);
+
+		if (next != m_free_by_offset.end())
+		{
+			size += next->second;
+			remove_free_range(next);
+		}
+
+		// Coalesce with the preceding free range.
+		auto prev = m_free_by_offset.lower_bound(offset);
+
+		if (prev != m_free_by_offset.begin())
+		{
+			prev--;
+
+			if (prev->first + prev->second == offset)
+			{
+				offset = prev->first;
+				size += prev->second;
+				remove_free_range(prev);
+			}
+		}
+
+		insert_free_range(offset, size);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void RangeAllocator::reset(uint32_t size)
+	{
+		m_size = size;
+		m_free_space = size;
+		m_free_by_offset.clear();
+		m_free_by_size.clear();
+		m_allocations.clear();
+
+		if (size > 0)
+			insert_free_range(0, size);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	uint32_t RangeAllocator::size()
+	{
+		return m_size;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	uint32_t RangeAllocator::free_space()
+	{
+		return m_free_space;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	uint32_t RangeAllocator::largest_free_range()
+	{
+		if (m_free_by_size.empty())
+			return 0;
+
+		return m_free_by_size.rbegin()->first;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void RangeAllocator::insert_free_range(uint32_t offset, uint32_t size)
+	{
+		m_free_by_offset[offset] = size;
+		m_free_by_size.insert(std::make_pair(size, offset));
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void RangeAllocator::remove_free_range(std::map<uint32_t, uint32_t>::iterator itr)
+	{
+		auto range = m_free_by_size.equal_range(itr->second);
+
+		for (auto size_itr = range.first; size_itr != range.second; size_itr++)
+		{
+			if (size_itr->second == itr->first)
+			{
+				m_free_by_size.erase(size_itr);
+				break;
+			}
+		}
+
+		m_free_by_offset.erase(itr);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	GeometryPool::GeometryPool(size_t vertex_size, uint32_t max_vertices, uint32_t max_indices, int attrib_count, VertexAttrib attribs[]) : m_vertex_size(vertex_size),
+		m_max_vertices(max_vertices),
+		m_max_indices(max_indices),
+		m_attribs(attribs, attribs + attrib_count),
+		m_vertex_allocator(max_vertices),
+		m_index_allocator(max_indices)
+	{
+		m_vbo = std::make_unique<VertexBuffer>(GL_STATIC_DRAW, m_vertex_size * m_max_vertices);
+		m_ibo = std::make_unique<IndexBuffer>(GL_STATIC_DRAW, sizeof(uint32_t) * m_max_indices);
+
+		create_vertex_array();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	GeometryPool::~GeometryPool() {}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	uint32_t GeometryPool::allocate(uint32_t num_vertices, const void* vertices, uint32_t num_indices, const uint32_t* indices)
+	{
+		// Fragmentation may be the only reason the request can't be satisfied.
+		if ((m_vertex_allocator.largest_free_range() < num_vertices && m_vertex_allocator.free_space() >= num_vertices) ||
+			(m_index_allocator.largest_free_range() < num_indices && m_index_allocator.free_space() >= num_indices))
+			defragment();
+
+		uint32_t vertex_offset = m_vertex_allocator.allocate(num_vertices);
+
+		if (vertex_offset == RANGE_ALLOCATOR_INVALID_OFFSET)
+		{
+			DW_LOG_ERROR("GeometryPool: Out of vertex memory");
+			return GEOMETRY_POOL_INVALID_HANDLE;
+		}
+
+		uint32_t index_offset = m_index_allocator.allocate(num_indices);
+
+		if (index_offset == RANGE_ALLOCATOR_INVALID_OFFSET)
+		{
+			m_vertex_allocator.free(vertex_offset);
+			DW_LOG_ERROR("GeometryPool: Out of index memory");
+			return GEOMETRY_POOL_INVALID_HANDLE;
+		}
+
+		m_vbo->set_data(m_vertex_size * vertex_offset, m_vertex_size * num_vertices, const_cast<void*>(vertices));
+		m_ibo->set_data(sizeof(uint32_t) * index_offset, sizeof(uint32_t) * num_indices, const_cast<uint32_t*>(indices));
+
+		uint32_t handle;
+
+		if (m_free_handles.empty())
+		{
+			handle = m_allocations.size();
+			m_allocations.push_back(Allocation());
+		}
+		else
+		{
+			handle = m_free_handles.back();
+			m_free_handles.pop_back();
+		}
+
+		Allocation& allocation = m_allocations[handle];
+
+		allocation.vertex_offset = vertex_offset;
+		allocation.vertex_count = num_vertices;
+		allocation.index_offset = index_offset;
+		allocation.index_count = num_indices;
+		allocation.live = true;
+
+		return handle;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void GeometryPool::free(uint32_t handle)
+	{
+		if (handle >= m_allocations.size() || !m_allocations[handle].live)
+			return;
+
+		Allocation& allocation = m_allocations[handle];
+
+		m_vertex_allocator.free(allocation.vertex_offset);
+		m_index_allocator.free(allocation.index_offset);
+
+		allocation.live = false;
+		m_free_handles.push_back(handle);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void GeometryPool::defragment()
+	{
+		// Copy every live allocation into tightly packed fresh buffers, then swap them in. Copying within a single
+		// buffer isn't allowed to overlap, which compaction would otherwise require.
+		std::unique_ptr<VertexBuffer> vbo = std::make_unique<VertexBuffer>(GL_STATIC_DRAW, m_vertex_size * m_max_vertices);
+		std::unique_ptr<IndexBuffer> ibo = std::make_unique<IndexBuffer>(GL_STATIC_DRAW, sizeof(uint32_t) * m_max_indices);
+
+		m_vertex_allocator.reset(m_max_vertices);
+		m_index_allocator.reset(m_max_indices);
+
+		for (auto& allocation : m_allocations)
+		{
+			if (!allocation.live)
+				continue;
+
+			uint32_t vertex_offset = m_vertex_allocator.allocate(allocation.vertex_count);
+			uint32_t index_offset = m_index_allocator.allocate(allocation.index_count);
+
+			GL_CHECK_ERROR(glBindBuffer(GL_COPY_READ_BUFFER, m_vbo->id()));
+			GL_CHECK_ERROR(glBindBuffer(GL_COPY_WRITE_BUFFER, vbo->id()));
+			GL_CHECK_ERROR(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, m_vertex_size * allocation.vertex_offset, m_vertex_size * vertex_offset, m_vertex_size * allocation.vertex_count));
+
+			GL_CHECK_ERROR(glBindBuffer(GL_COPY_READ_BUFFER, m_ibo->id()));
+			GL_CHECK_ERROR(glBindBuffer(GL_COPY_WRITE_BUFFER, ibo->id()));
+			GL_CHECK_ERROR(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, sizeof(uint32_t) * allocation.index_offset, sizeof(uint32_t) * index_offset, sizeof(uint32_t) * allocation.index_count));
+
+			allocation.vertex_offset = vertex_offset;
+			allocation.index_offset = index_offset;
+		}
+
+		GL_CHECK_ERROR(glBindBuffer(GL_COPY_READ_BUFFER, 0));
+		GL_CHECK_ERROR(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+
+		m_vbo = std::move(vbo);
+		m_ibo = std::move(ibo);
+
+		create_vertex_array();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	uint32_t GeometryPool::base_vertex(uint32_t handle)
+	{
+		return m_allocations[handle].vertex_offset;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	uint32_t GeometryPool::base_index(uint32_t handle)
+	{
+		return m_allocations[handle].index_offset;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	VertexFormat* GeometryPool::vertex_format()
+	{
+		return VertexFormat::get(m_vertex_size, m_attribs.size(), &m_attribs[0]);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void GeometryPool::create_vertex_array()
+	{
+		m_vao = std::make_unique<VertexArray>(m_vbo.get(), m_ibo.get(), m_vertex_size, m_attribs.size(), &m_attribs[0]);
+
+		if (!m_vao)
+			DW_LOG_ERROR("Failed to create Vertex Array");
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+} // namespace dw
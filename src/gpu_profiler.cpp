@@ -0,0 +1,210 @@
+#include <gpu_profiler.h>
+#include <logger.h>
+#include <imgui.h>
+#include <algorithm>
+
+namespace dw
+{
+#if !defined(__EMSCRIPTEN__)
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	GPUProfiler::GPUProfiler() {}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	GPUProfiler::~GPUProfiler() {}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void GPUProfiler::begin_frame()
+	{
+		m_frame++;
+		m_depth = 0;
+
+		for (auto& scope : m_scopes)
+		{
+			scope->active = false;
+			resolve(*scope);
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void GPUProfiler::begin(const std::string& name)
+	{
+		if (!m_enabled)
+			return;
+
+		Scope* scope = find_or_create(name);
+		uint32_t slot = m_frame % GPU_PROFILER_LATENCY;
+
+		scope->depth = m_depth++;
+
+		// The GPU is more than GPU_PROFILER_LATENCY frames behind. Skip this frame rather than wait.
+		if (scope->pending[slot])
+			return;
+
+		if (!scope->start[slot])
+		{
+			scope->start[slot] = std::make_unique<Query>();
+			scope->end[slot] = std::make_unique<Query>();
+		}
+
+		scope->start[slot]->query_counter(GL_TIMESTAMP);
+		scope->active = true;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void GPUProfiler::end(const std::string& name)
+	{
+		if (!m_enabled)
+			return;
+
+		if (m_depth > 0)
+			m_depth--;
+
+		auto itr = m_scope_map.find(name);
+
+		if (itr == m_scope_map.end() || !itr->second->active)
+			return;
+
+		Scope* scope = itr->second;
+		uint32_t slot = m_frame % GPU_PROFILER_LATENCY;
+
+		scope->end[slot]->query_counter(GL_TIMESTAMP);
+		scope->pending[slot] = true;
+		scope->active = false;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	bool GPUProfiler::stats(const std::string& name, Stats& stats)
+	{
+		auto itr = m_scope_map.find(name);
+
+		if (itr == m_scope_map.end() || itr->second->history_count == 0)
+			return false;
+
+		stats = itr->second->stats;
+
+		return true;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void GPUProfiler::ui()
+	{
+		ImGui::Columns(5, "GPU Profiler");
+
+		ImGui::Text("Scope");
+		ImGui::NextColumn();
+		ImGui::Text("Last (ms)");
+		ImGui::NextColumn();
+		ImGui::Text("Min (ms)");
+		ImGui::NextColumn();
+		ImGui::Text("Avg (ms)");
+		ImGui::NextColumn();
+		ImGui::Text("Max (ms)");
+		ImGui::NextColumn();
+
+		ImGui::Separator();
+
+		for (auto& scope : m_scopes)
+		{
+			ImGui::Text("%*s%s", scope->depth * 2, "", scope->name.c_str());
+			ImGui::NextColumn();
+			ImGui::Text("%.3f", scope->stats.last_ms);
+			ImGui::NextColumn();
+			ImGui::Text("%.3f", scope->stats.min_ms);
+			ImGui::NextColumn();
+			ImGui::Text("%.3f", scope->stats.avg_ms);
+			ImGui::NextColumn();
+			ImGui::Text("%.3f", scope->stats.max_ms);
+			ImGui::NextColumn();
+		}
+
+		ImGui::Columns(1);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void GPUProfiler::shutdown()
+	{
+		m_scope_map.clear();
+		m_scopes.clear();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	GPUProfiler::Scope* GPUProfiler::find_or_create(const std::string& name)
+	{
+		auto itr = m_scope_map.find(name);
+
+		if (itr != m_scope_map.end())
+			return itr->second;
+
+		Scope* scope = new Scope();
+
+		scope->name = name;
+
+		for (uint32_t i = 0; i < GPU_PROFILER_LATENCY; i++)
+			scope->pending[i] = false;
+
+		m_scopes.push_back(std::unique_ptr<Scope>(scope));
+		m_scope_map[name] = scope;
+
+		return scope;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void GPUProfiler::resolve(Scope& scope)
+	{
+		bool updated = false;
+
+		// Oldest slot first so 'last' ends up as the most recent resolved frame.
+		for (uint32_t i = 1; i <= GPU_PROFILER_LATENCY; i++)
+		{
+			uint32_t slot = (m_frame + i) % GPU_PROFILER_LATENCY;
+
+			if (!scope.pending[slot] || !scope.end[slot]->result_available() || !scope.start[slot]->result_available())
+				continue;
+
+			uint64_t start = 0;
+			uint64_t end = 0;
+
+			// Both results are available, so these reads do not stall.
+			scope.start[slot]->result_64(&start);
+			scope.end[slot]->result_64(&end);
+			scope.pending[slot] = false;
+
+			scope.history[scope.history_head] = double(end - start) / 1000000.0;
+			scope.history_head = (scope.history_head + 1) % GPU_PROFILER_HISTORY;
+			scope.history_count = std::min(scope.history_count + 1, uint32_t(GPU_PROFILER_HISTORY));
+			scope.stats.last_ms = double(end - start) / 1000000.0;
+
+			updated = true;
+		}
+
+		if (!updated)
+			return;
+
+		double sum = 0.0;
+
+		scope.stats.min_ms = scope.history[0];
+		scope.stats.max_ms = scope.history[0];
+
+		for (uint32_t i = 0; i < scope.history_count; i++)
+		{
+			scope.stats.min_ms = std::min(scope.stats.min_ms, scope.history[i]);
+			scope.stats.max_ms = std::max(scope.stats.max_ms, scope.history[i]);
+			sum += scope.history[i];
+		}
+
+		scope.stats.avg_ms = sum / double(scope.history_count);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+#endif
+} // namespace dw
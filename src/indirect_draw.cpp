@@ -0,0 +1,133 @@
+#include <indirect_draw.h>
+#include <mesh.h>
+#include <logger.h>
+#include <string.h>
+
+namespace dw
+{
+#if !defined(__EMSCRIPTEN__)
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	IndirectDrawList::IndirectDrawList(uint32_t max_draws) : m_max_draws(max_draws)
+	{
+		m_commands.reserve(m_max_draws);
+		m_buffer = std::make_unique<StreamBuffer>(GL_DRAW_INDIRECT_BUFFER, sizeof(DrawElementsIndirectCommand) * m_max_draws);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	IndirectDrawList::~IndirectDrawList() {}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void IndirectDrawList::clear()
+	{
+		m_commands.clear();
+		m_instance_count = 0;
+		m_vao = nullptr;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	uint32_t IndirectDrawList::add(Mesh* mesh, uint32_t sub_mesh, uint32_t instance_count)
+	{
+		if (m_commands.size() == m_max_draws)
+		{
+			DW_LOG_ERROR("IndirectDrawList: Draw count above allowed limit!");
+			return m_instance_count;
+		}
+
+		if (!m_vao)
+			m_vao = mesh->mesh_vertex_array();
+		else if (m_vao != mesh->mesh_vertex_array())
+		{
+			DW_LOG_ERROR("IndirectDrawList: All meshes must share a Vertex Array. Load them from the same GeometryPool.");
+			return m_instance_count;
+		}
+
+		SubMesh& submesh = mesh->sub_meshes()[sub_mesh];
+
+		DrawElementsIndirectCommand cmd;
+
+		cmd.count = submesh.index_count;
+		cmd.instance_count = instance_count;
+		cmd.first_index = mesh->base_index() + submesh.base_index;
+		cmd.base_vertex = mesh->base_vertex() + submesh.base_vertex;
+		cmd.base_instance = m_instance_count;
+
+		m_commands.push_back(cmd);
+		m_instance_count += instance_count;
+
+		return cmd.base_instance;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void IndirectDrawList::add(Mesh* mesh, uint32_t instance_count)
+	{
+		for (uint32_t i = 0; i < mesh->sub_mesh_count(); i++)
+			add(mesh, i, instance_count);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void IndirectDrawList::submit(GLenum mode, Program* program)
+	{
+		if (m_commands.empty())
+			return;
+
+		m_vao->bind();
+
+		GLint location = -1;
+
+		if (program && !shader_draw_parameters())
+			location = program->uniform_location("u_BaseInstance");
+
+		if (!GLAD_GL_VERSION_4_3 || location != -1)
+		{
+			// Every draw needs its own u_BaseInstance value. Base instance is reserved in indirect commands before GL 4.2,
+			// so these are direct draws.
+			for (size_t i = 0; i < m_commands.size(); i++)
+			{
+				const DrawElementsIndirectCommand& cmd = m_commands[i];
+
+				if (location != -1)
+					GL_CHECK_ERROR(glUniform1i(location, int(cmd.base_instance)));
+
+				GL_CHECK_ERROR(glDrawElementsInstancedBaseVertex(mode, cmd.count, GL_UNSIGNED_INT, (void*)(sizeof(uint32_t) * cmd.first_index), cmd.instance_count, cmd.base_vertex));
+			}
+
+			return;
+		}
+
+		size_t offset = 0;
+
+		m_buffer->begin_frame();
+		void* ptr = m_buffer->allocate(sizeof(DrawElementsIndirectCommand) * m_commands.size(), sizeof(DrawElementsIndirectCommand), offset);
+
+		if (!ptr)
+		{
+			m_buffer->end_frame();
+			return;
+		}
+
+		memcpy(ptr, m_commands.data(), sizeof(DrawElementsIndirectCommand) * m_commands.size());
+		m_buffer->flush();
+
+		m_buffer->bind();
+		GL_CHECK_ERROR(glMultiDrawElementsIndirect(mode, GL_UNSIGNED_INT, (void*)offset, m_commands.size(), sizeof(DrawElementsIndirectCommand)));
+		m_buffer->unbind();
+
+		m_buffer->end_frame();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	bool IndirectDrawList::shader_draw_parameters()
+	{
+		return GLAD_GL_VERSION_4_6;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+#endif
+} // namespace dw
@@ -31,7 +31,10 @@ namespace dw
 			Material* mat = new Material();
 
 			for (int i = 0; i < num_textures; i++)
+			{
 				mat->m_textures[i] = textures[i];
+				mat->m_samplers[i] = Sampler::get(SamplerDesc());
+			}
 
 			mat->m_albedo_val = albedo;
 
@@ -98,7 +101,10 @@ namespace dw
 	Material::Material() 
 	{
 		for (uint32_t i = 0; i < 16; i++)
+		{
 			m_textures[i] = nullptr;
+			m_samplers[i] = nullptr;
+		}
 	}
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
@@ -108,11 +114,13 @@ namespace dw
 		for (uint32_t i = 0; i < 16; i++)
 		{
 			m_textures[i] = nullptr;
+			m_samplers[i] = nullptr;
 
 			if (!textures[i].empty())
 			{
 				// First index must always be diffuse/albedo, so SRGB is set to true.
 				m_textures[i] = load_texture(textures[i], i == 0 ? true : false);
+				m_samplers[i] = Sampler::get(SamplerDesc());
 			}
 		}
 	}
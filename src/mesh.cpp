@@ -1,4 +1,5 @@
 #include <mesh.h>
+#include <geometry_pool.h>
 #include <macros.h>
 #include <material.h>
 #include <logger.h>
@@ -43,6 +44,16 @@ namespace dw
 		"aiTextureType_REFLECTION"
 	};
 
+	// Vertex layout of the Vertex structure.
+	static VertexAttrib kVertexAttribs[] =
+	{
+		{ 3, GL_FLOAT, false, 0 },
+		{ 2, GL_FLOAT, false, offsetof(Vertex, tex_coord) },
+		{ 3, GL_FLOAT, false, offsetof(Vertex, normal) },
+		{ 3, GL_FLOAT, false, offsetof(Vertex, tangent) },
+		{ 3, GL_FLOAT, false, offsetof(Vertex, bitangent) }
+	};
+
 	// -----------------------------------------------------------------------------------------------------------------------------------
 	// Assimp loader helper method declarations.
 	// -----------------------------------------------------------------------------------------------------------------------------------
@@ -52,11 +63,11 @@ namespace dw
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
 
-	Mesh* Mesh::load(const std::string& path, bool load_materials)
+	Mesh* Mesh::load(const std::string& path, bool load_materials, GeometryPool* pool)
 	{
 		if (m_cache.find(path) == m_cache.end())
 		{
-			Mesh* mesh = new Mesh(path, load_materials);
+			Mesh* mesh = new Mesh(path, load_materials, pool);
 			m_cache[path] = mesh;
 			return mesh;
 		}
@@ -66,11 +77,12 @@ namespace dw
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
 
-	Mesh*  Mesh::load(const std::string& name, int num_vertices, Vertex* vertices, int num_indices, uint32_t* indices, int num_sub_meshes, SubMesh* sub_meshes, glm::vec3 max_extents, glm::vec3 min_extents)
+	Mesh*  Mesh::load(const std::string& name, int num_vertices, Vertex* vertices, int num_indices, uint32_t* indices, int num_sub_meshes, SubMesh* sub_meshes, glm::vec3 max_extents, glm::vec3 min_extents, GeometryPool* pool)
 	{
 		if (m_cache.find(name) == m_cache.end())
 		{
 			Mesh* mesh = new Mesh();
+			mesh->m_pool = pool;
 
 			// Manually assign properties...
 			mesh->m_vertices = vertices;
@@ -277,6 +289,25 @@ namespace dw
 
 	void Mesh::create_gpu_objects()
 	{
+		// Mesh vertices are uploaded as is, so the pool's vertices must be laid out like Vertex.
+		if (m_pool && m_pool->vertex_size() != sizeof(Vertex))
+		{
+			DW_LOG_ERROR("Geometry Pool vertex size (" + std::to_string(m_pool->vertex_size()) + ") does not match Mesh vertex size (" + std::to_string(sizeof(Vertex)) + "). Falling back to dedicated buffers.");
+			m_pool = nullptr;
+		}
+
+		if (m_pool)
+		{
+			// Sub-allocate from the shared pool. No per-mesh GPU objects are created.
+			m_pool_handle = m_pool->allocate(m_vertex_count, m_vertices, m_index_count, m_indices);
+
+			if (m_pool_handle != GEOMETRY_POOL_INVALID_HANDLE)
+				return;
+
+			DW_LOG_ERROR("Failed to allocate from Geometry Pool. Falling back to dedicated buffers.");
+			m_pool = nullptr;
+		}
+
 		// Create vertex buffer.
         m_vbo = std::make_unique<VertexBuffer>(GL_STATIC_DRAW, sizeof(Vertex) * m_vertex_count, m_vertices);
 
@@ -289,18 +320,8 @@ namespace dw
 		if (!m_ibo)
 			DW_LOG_ERROR("Failed to create Index Buffer");
         
-		// Declare vertex attributes.
-		VertexAttrib attribs[] =
-		{
-			{ 3, GL_FLOAT, false, 0 },
-			{ 2, GL_FLOAT, false, offsetof(Vertex, tex_coord) },
-			{ 3, GL_FLOAT, false, offsetof(Vertex, normal) },
-			{ 3, GL_FLOAT, false, offsetof(Vertex, tangent) },
-			{ 3, GL_FLOAT, false, offsetof(Vertex, bitangent) }
-		};
-
 		// Create vertex array.
-        m_vao = std::make_unique<VertexArray>(m_vbo.get(), m_ibo.get(), sizeof(Vertex), 5, attribs);
+        m_vao = std::make_unique<VertexArray>(m_vbo.get(), m_ibo.get(), sizeof(Vertex), 5, kVertexAttribs);
 
 		if (!m_vao)
 			DW_LOG_ERROR("Failed to create Vertex Array");
@@ -308,11 +329,56 @@ namespace dw
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
 
+	VertexArray* Mesh::mesh_vertex_array()
+	{
+		return m_pool ? m_pool->vertex_array() : m_vao.get();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	VertexFormat* Mesh::vertex_format()
+	{
+		if (m_pool)
+			return m_pool->vertex_format();
+
+		return VertexFormat::get(sizeof(Vertex), 5, kVertexAttribs);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	Buffer* Mesh::mesh_vertex_buffer()
+	{
+		return m_pool ? m_pool->vertex_buffer() : m_vbo.get();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	IndexBuffer* Mesh::mesh_index_buffer()
+	{
+		return m_pool ? m_pool->index_buffer() : m_ibo.get();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	uint32_t Mesh::base_vertex()
+	{
+		return m_pool ? m_pool->base_vertex(m_pool_handle) : 0;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	uint32_t Mesh::base_index()
+	{
+		return m_pool ? m_pool->base_index(m_pool_handle) : 0;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
 	Mesh::Mesh() {}
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
 
-	Mesh::Mesh(const std::string& path, bool load_materials)
+	Mesh::Mesh(const std::string& path, bool load_materials, GeometryPool* pool) : m_pool(pool)
 	{
 		load_from_disk(path, load_materials);
 		create_gpu_objects();
@@ -329,6 +395,10 @@ namespace dw
 				Material::unload(m_sub_meshes[i].mat);
 		}
 
+		// Release pool allocation.
+		if (m_pool)
+			m_pool->free(m_pool_handle);
+
 		// Delete geometry data.
 		DW_SAFE_DELETE_ARRAY(m_sub_meshes);
 		DW_SAFE_DELETE_ARRAY(m_vertices);
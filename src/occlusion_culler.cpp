@@ -0,0 +1,348 @@
+#include <occlusion_culler.h>
+#include <mesh.h>
+#include <simd.h>
+#include <worker_pool.h>
+#include <algorithm>
+#include <thread>
+#include <math.h>
+#include <float.h>
+
+namespace dw
+{
+	// Projected vertices closer than this to the eye plane are rejected to avoid dividing by zero.
+	static const float kMinW = 1e-5f;
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	OcclusionCuller::OcclusionCuller(uint32_t width, uint32_t height, uint32_t num_threads) : m_width((width + 3) & ~3u), m_height(height), m_view_projection(1.0f)
+	{
+		if (num_threads == 0)
+			num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+		m_num_bands = std::min(num_threads, m_height);
+		m_depth.resize(m_width * m_height, 1.0f);
+		m_bins.resize(m_num_bands);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	OcclusionCuller::~OcclusionCuller() {}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void OcclusionCuller::begin_frame(const glm::mat4& view_projection)
+	{
+		m_view_projection = view_projection;
+		m_triangles.clear();
+
+		std::fill(m_depth.begin(), m_depth.end(), 1.0f);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void OcclusionCuller::add_occluder(const void* positions, size_t stride, const uint32_t* indices, uint32_t index_count, uint32_t base_vertex, const glm::mat4& model)
+	{
+		glm::mat4	   mvp = m_view_projection * model;
+		const uint8_t* base = static_cast<const uint8_t*>(positions);
+
+		for (uint32_t i = 0; i + 2 < index_count; i += 3)
+		{
+			glm::vec4 clip[3];
+			uint32_t  num_behind = 0;
+
+			for (int j = 0; j < 3; j++)
+			{
+				const glm::vec3& p = *reinterpret_cast<const glm::vec3*>(base + (base_vertex + indices[i + j]) * stride);
+
+				clip[j] = mvp * glm::vec4(p, 1.0f);
+
+				if (clip[j].z + clip[j].w < 0.0f)
+					num_behind++;
+			}
+
+			if (num_behind == 3)
+				continue;
+
+			if (num_behind == 0)
+			{
+				add_triangle(clip[0], clip[1], clip[2]);
+				continue;
+			}
+
+			// Clip against the near plane (z = -w), which leaves a triangle or a quad in front of it.
+			glm::vec4 polygon[4];
+			uint32_t  num_vertices = 0;
+
+			for (int j = 0; j < 3; j++)
+			{
+				const glm::vec4& a = clip[j];
+				const glm::vec4& b = clip[(j + 1) % 3];
+
+				float da = a.z + a.w;
+				float db = b.z + b.w;
+
+				if (da >= 0.0f)
+					polygon[num_vertices++] = a;
+
+				if ((da >= 0.0f) != (db >= 0.0f))
+					polygon[num_vertices++] = a + (b - a) * (da / (da - db));
+			}
+
+			for (uint32_t j = 2; j < num_vertices; j++)
+				add_triangle(polygon[0], polygon[j - 1], polygon[j]);
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void OcclusionCuller::add_occluder(Mesh* mesh, const glm::mat4& model)
+	{
+		for (uint32_t i = 0; i < mesh->sub_mesh_count(); i++)
+		{
+			SubMesh& submesh = mesh->sub_meshes()[i];
+			add_occluder(&mesh->vertices()[0].position, sizeof(Vertex), mesh->indices() + submesh.base_index, submesh.index_count, submesh.base_vertex, model);
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void OcclusionCuller::add_triangle(const glm::vec4& c0, const glm::vec4& c1, const glm::vec4& c2)
+	{
+		const glm::vec4* clip[3] = { &c0, &c1, &c2 };
+		Triangle		 triangle;
+
+		for (int j = 0; j < 3; j++)
+		{
+			// Only reachable with projections whose near plane passes through the eye.
+			if (clip[j]->w < kMinW)
+				return;
+
+			float inv_w = 1.0f / clip[j]->w;
+
+			triangle.v[j] = glm::vec3((clip[j]->x * inv_w * 0.5f + 0.5f) * m_width, (clip[j]->y * inv_w * 0.5f + 0.5f) * m_height, clip[j]->z * inv_w * 0.5f + 0.5f);
+		}
+
+		// Trivially reject triangles entirely off screen or beyond the far plane.
+		float min_x = std::min(triangle.v[0].x, std::min(triangle.v[1].x, triangle.v[2].x));
+		float max_x = std::max(triangle.v[0].x, std::max(triangle.v[1].x, triangle.v[2].x));
+		float min_y = std::min(triangle.v[0].y, std::min(triangle.v[1].y, triangle.v[2].y));
+		float max_y = std::max(triangle.v[0].y, std::max(triangle.v[1].y, triangle.v[2].y));
+		float min_z = std::min(triangle.v[0].z, std::min(triangle.v[1].z, triangle.v[2].z));
+
+		if (max_x < 0.0f || max_y < 0.0f || min_x >= float(m_width) || min_y >= float(m_height) || min_z > 1.0f)
+			return;
+
+		m_triangles.push_back(triangle);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void OcclusionCuller::rasterize()
+	{
+		for (auto& bin : m_bins)
+			bin.clear();
+
+		// Bin triangles to every band their vertical extent overlaps.
+		for (uint32_t i = 0; i < m_triangles.size(); i++)
+		{
+			const Triangle& t = m_triangles[i];
+
+			float min_y = std::min(t.v[0].y, std::min(t.v[1].y, t.v[2].y));
+			float max_y = std::max(t.v[0].y, std::max(t.v[1].y, t.v[2].y));
+
+			// Same row range as rasterize_triangle(), matched against the exact band ranges.
+			int32_t y_start = std::max(int32_t(floorf(min_y)), 0);
+			int32_t y_end = std::min(int32_t(ceilf(max_y)), int32_t(m_height));
+
+			for (uint32_t band = 0; band < m_num_bands; band++)
+			{
+				int32_t band_min_y = int32_t(band * m_height / m_num_bands);
+				int32_t band_max_y = int32_t((band + 1) * m_height / m_num_bands);
+
+				if (y_start < band_max_y && y_end > band_min_y)
+					m_bins[band].push_back(i);
+			}
+		}
+
+		// Bands cover disjoint rows, so they are rasterized on the shared workers without synchronization.
+		WorkerPool::get().run(m_num_bands, [this](uint32_t band) { rasterize_band(band); });
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	bool OcclusionCuller::visible(const AABB& aabb)
+	{
+		float min_x = FLT_MAX;
+		float min_y = FLT_MAX;
+		float max_x = -FLT_MAX;
+		float max_y = -FLT_MAX;
+		float min_z = FLT_MAX;
+
+		for (int i = 0; i < 8; i++)
+		{
+			glm::vec3 corner = glm::vec3(i & 1 ? aabb.max.x : aabb.min.x, i & 2 ? aabb.max.y : aabb.min.y, i & 4 ? aabb.max.z : aabb.min.z);
+			glm::vec4 clip = m_view_projection * glm::vec4(corner, 1.0f);
+
+			// Boxes reaching in front of the near plane are always visible.
+			if (clip.z + clip.w < 0.0f || clip.w < kMinW)
+				return true;
+
+			float inv_w = 1.0f / clip.w;
+			float x = (clip.x * inv_w * 0.5f + 0.5f) * m_width;
+			float y = (clip.y * inv_w * 0.5f + 0.5f) * m_height;
+
+			min_x = std::min(min_x, x);
+			max_x = std::max(max_x, x);
+			min_y = std::min(min_y, y);
+			max_y = std::max(max_y, y);
+			min_z = std::min(min_z, clip.z * inv_w * 0.5f + 0.5f);
+		}
+
+		if (max_x < 0.0f || max_y < 0.0f || min_x >= float(m_width) || min_y >= float(m_height))
+			return false;
+
+		// Every pixel the box may touch. The nearest point of the box must be behind all of them to be hidden.
+		uint32_t x0 = uint32_t(std::max(min_x, 0.0f));
+		uint32_t x1 = uint32_t(std::min(max_x, float(m_width - 1)));
+		uint32_t y0 = uint32_t(std::max(min_y, 0.0f));
+		uint32_t y1 = uint32_t(std::min(max_y, float(m_height - 1)));
+
+#if defined(DW_SIMD_SSE)
+		__m128 z = _mm_set1_ps(min_z);
+
+		// Whole 4 pixel blocks are tested. Extra pixels at the ends only make the test more conservative.
+		x0 &= ~3u;
+
+		for (uint32_t y = y0; y <= y1; y++)
+		{
+			const float* row = &m_depth[y * m_width];
+
+			for (uint32_t x = x0; x <= x1; x += 4)
+			{
+				if (_mm_movemask_ps(_mm_cmplt_ps(z, _mm_loadu_ps(row + x))))
+					return true;
+			}
+		}
+#else
+		for (uint32_t y = y0; y <= y1; y++)
+		{
+			for (uint32_t x = x0; x <= x1; x++)
+			{
+				if (min_z < m_depth[y * m_width + x])
+					return true;
+			}
+		}
+#endif
+
+		return false;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void OcclusionCuller::rasterize_band(uint32_t band)
+	{
+		uint32_t min_y = band * m_height / m_num_bands;
+		uint32_t max_y = (band + 1) * m_height / m_num_bands;
+
+		for (uint32_t i : m_bins[band])
+			rasterize_triangle(m_triangles[i], min_y, max_y);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void OcclusionCuller::rasterize_triangle(const Triangle& triangle, uint32_t band_min_y, uint32_t band_max_y)
+	{
+		glm::vec3 v0 = triangle.v[0];
+		glm::vec3 v1 = triangle.v[1];
+		glm::vec3 v2 = triangle.v[2];
+
+		float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+
+		if (fabsf(area) < 1e-8f)
+			return;
+
+		// Occluders are treated as two-sided: flip clockwise triangles so the edge functions are positive inside.
+		if (area < 0.0f)
+		{
+			std::swap(v1, v2);
+			area = -area;
+		}
+
+		// Edge functions E(x, y) = a * x + b * y + c, positive on the inner side of each edge. Pixel centers exactly on an
+		// edge count as covered so that edges shared between triangles leave no cracks.
+		float a0 = v1.y - v2.y, b0 = v2.x - v1.x, c0 = v1.x * v2.y - v2.x * v1.y;
+		float a1 = v2.y - v0.y, b1 = v0.x - v2.x, c1 = v2.x * v0.y - v0.x * v2.y;
+		float a2 = v0.y - v1.y, b2 = v1.x - v0.x, c2 = v0.x * v1.y - v1.x * v0.y;
+
+		// Depth is linear in screen space: z = z0 * w0 + z1 * w1 + z2 * w2 with barycentrics w = E / area.
+		float inv_area = 1.0f / area;
+		float dzdx = (a0 * v0.z + a1 * v1.z + a2 * v2.z) * inv_area;
+		float dzdy = (b0 * v0.z + b1 * v1.z + b2 * v2.z) * inv_area;
+		float z_c = (c0 * v0.z + c1 * v1.z + c2 * v2.z) * inv_area;
+
+		int32_t x_start = std::max(int32_t(floorf(std::min(v0.x, std::min(v1.x, v2.x)))), 0);
+		int32_t x_end = std::min(int32_t(ceilf(std::max(v0.x, std::max(v1.x, v2.x)))), int32_t(m_width));
+		int32_t y_start = std::max(int32_t(floorf(std::min(v0.y, std::min(v1.y, v2.y)))), int32_t(band_min_y));
+		int32_t y_end = std::min(int32_t(ceilf(std::max(v0.y, std::max(v1.y, v2.y)))), int32_t(band_max_y));
+
+		if (x_start >= x_end || y_start >= y_end)
+			return;
+
+#if defined(DW_SIMD_SSE)
+		// Four horizontally adjacent pixels per step. Rows are a multiple of 4 wide, so aligned blocks never run past a row.
+		x_start &= ~3;
+
+		__m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+		__m128 zero = _mm_setzero_ps();
+
+		for (int32_t y = y_start; y < y_end; y++)
+		{
+			float  py = float(y) + 0.5f;
+			float* row = &m_depth[y * m_width];
+
+			__m128 row_e0 = _mm_set1_ps(b0 * py + c0);
+			__m128 row_e1 = _mm_set1_ps(b1 * py + c1);
+			__m128 row_e2 = _mm_set1_ps(b2 * py + c2);
+			__m128 row_z = _mm_set1_ps(dzdy * py + z_c);
+
+			for (int32_t x = x_start; x < x_end; x += 4)
+			{
+				__m128 px = _mm_add_ps(_mm_set1_ps(float(x)), offsets);
+
+				__m128 e0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a0), px), row_e0);
+				__m128 e1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a1), px), row_e1);
+				__m128 e2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a2), px), row_e2);
+
+				__m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+
+				if (!_mm_movemask_ps(inside))
+					continue;
+
+				__m128 z = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(dzdx), px), row_z);
+				__m128 depth = _mm_loadu_ps(row + x);
+				__m128 nearest = _mm_min_ps(depth, z);
+
+				_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, depth)));
+			}
+		}
+#else
+		for (int32_t y = y_start; y < y_end; y++)
+		{
+			float  py = float(y) + 0.5f;
+			float* row = &m_depth[y * m_width];
+
+			for (int32_t x = x_start; x < x_end; x++)
+			{
+				float px = float(x) + 0.5f;
+
+				if (a0 * px + b0 * py + c0 < 0.0f || a1 * px + b1 * py + c1 < 0.0f || a2 * px + b2 * py + c2 < 0.0f)
+					continue;
+
+				row[x] = std::min(row[x], dzdx * px + dzdy * py + z_c);
+			}
+		}
+#endif
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+} // namespace dw
@@ -2,6 +2,7 @@
 #include <utility.h>
 #include <logger.h>
 #include <gtc/type_ptr.hpp>
+#include <string.h>
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
@@ -9,6 +10,17 @@ namespace dw
 {
 	// -----------------------------------------------------------------------------------------------------------------------------------
 
+	bool dsa_supported()
+	{
+#if defined(__EMSCRIPTEN__)
+		return false;
+#else
+		return GLAD_GL_VERSION_4_5 != 0;
+#endif
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
 	Texture::Texture()
 	{
 		GL_CHECK_ERROR(glGenTextures(1, &m_gl_tex));
@@ -41,6 +53,14 @@ namespace dw
 
 	void Texture::generate_mipmaps()
 	{
+#if !defined(__EMSCRIPTEN__)
+		if (dsa_supported())
+		{
+			GL_CHECK_ERROR(glGenerateTextureMipmap(m_gl_tex));
+			return;
+		}
+#endif
+
 		GL_CHECK_ERROR(glBindTexture(m_target, m_gl_tex));
 		GL_CHECK_ERROR(glGenerateMipmap(m_target));
 		GL_CHECK_ERROR(glBindTexture(m_target, 0));
@@ -62,6 +82,13 @@ namespace dw
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
 
+	GLenum Texture::internal_format()
+	{
+		return m_internal_format;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
 	uint32_t Texture::array_size()
 	{
 		return m_array_size;
@@ -71,6 +98,16 @@ namespace dw
     
     void Texture::set_wrapping(GLenum s, GLenum t, GLenum r)
     {
+#if !defined(__EMSCRIPTEN__)
+        if (dsa_supported())
+        {
+            GL_CHECK_ERROR(glTextureParameteri(m_gl_tex, GL_TEXTURE_WRAP_S, s));
+            GL_CHECK_ERROR(glTextureParameteri(m_gl_tex, GL_TEXTURE_WRAP_T, t));
+            GL_CHECK_ERROR(glTextureParameteri(m_gl_tex, GL_TEXTURE_WRAP_R, r));
+            return;
+        }
+#endif
+
         GL_CHECK_ERROR(glBindTexture(m_target, m_gl_tex));
         GL_CHECK_ERROR(glTexParameteri(m_target, GL_TEXTURE_WRAP_S, s));
         GL_CHECK_ERROR(glTexParameteri(m_target, GL_TEXTURE_WRAP_T, t));
@@ -84,6 +121,13 @@ namespace dw
     {
 #if !defined(__EMSCRIPTEN__)
         float border_color[] = { r, g, b, a };
+
+        if (dsa_supported())
+        {
+            GL_CHECK_ERROR(glTextureParameterfv(m_gl_tex, GL_TEXTURE_BORDER_COLOR, border_color));
+            return;
+        }
+
         GL_CHECK_ERROR(glBindTexture(m_target, m_gl_tex));
         GL_CHECK_ERROR(glTexParameterfv(m_target, GL_TEXTURE_BORDER_COLOR, border_color));
         GL_CHECK_ERROR(glBindTexture(m_target, 0));
@@ -94,6 +138,14 @@ namespace dw
     
     void Texture::set_min_filter(GLenum filter)
     {
+#if !defined(__EMSCRIPTEN__)
+        if (dsa_supported())
+        {
+            GL_CHECK_ERROR(glTextureParameteri(m_gl_tex, GL_TEXTURE_MIN_FILTER, filter));
+            return;
+        }
+#endif
+
         GL_CHECK_ERROR(glBindTexture(m_target, m_gl_tex));
         GL_CHECK_ERROR(glTexParameteri(m_target, GL_TEXTURE_MIN_FILTER, filter));
         GL_CHECK_ERROR(glBindTexture(m_target, 0));
@@ -103,6 +155,14 @@ namespace dw
     
     void Texture::set_mag_filter(GLenum filter)
     {
+#if !defined(__EMSCRIPTEN__)
+        if (dsa_supported())
+        {
+            GL_CHECK_ERROR(glTextureParameteri(m_gl_tex, GL_TEXTURE_MAG_FILTER, filter));
+            return;
+        }
+#endif
+
         GL_CHECK_ERROR(glBindTexture(m_target, m_gl_tex));
         GL_CHECK_ERROR(glTexParameteri(m_target, GL_TEXTURE_MAG_FILTER, filter));
         GL_CHECK_ERROR(glBindTexture(m_target, 0));
@@ -126,6 +186,12 @@ namespace dw
 
 	void Texture::set_compare_mode(GLenum mode)
 	{
+		if (dsa_supported())
+		{
+			GL_CHECK_ERROR(glTextureParameteri(m_gl_tex, GL_TEXTURE_COMPARE_MODE, mode));
+			return;
+		}
+
 		GL_CHECK_ERROR(glBindTexture(m_target, m_gl_tex));
 		GL_CHECK_ERROR(glTexParameteri(m_target, GL_TEXTURE_COMPARE_MODE, mode));
 		GL_CHECK_ERROR(glBindTexture(m_target, 0));
@@ -135,6 +201,12 @@ namespace dw
 
 	void Texture::set_compare_func(GLenum func)
 	{
+		if (dsa_supported())
+		{
+			GL_CHECK_ERROR(glTextureParameteri(m_gl_tex, GL_TEXTURE_COMPARE_FUNC, func));
+			return;
+		}
+
 		GL_CHECK_ERROR(glBindTexture(m_target, m_gl_tex));
 		GL_CHECK_ERROR(glTexParameteri(m_target, GL_TEXTURE_COMPARE_FUNC, func));
 		GL_CHECK_ERROR(glBindTexture(m_target, 0));
@@ -221,6 +293,20 @@ namespace dw
 		for (int i = 0; i < mip_level; i++)
 			width = std::max(1, width / 2);
 
+		if (dsa_supported())
+		{
+			if (m_array_size > 1)
+			{
+				GL_CHECK_ERROR(glTextureSubImage2D(m_gl_tex, mip_level, 0, array_index, width, 1, m_format, m_type, data));
+			}
+			else
+			{
+				GL_CHECK_ERROR(glTextureSubImage1D(m_gl_tex, mip_level, 0, width, m_format, m_type, data));
+			}
+
+			return;
+		}
+
 		GL_CHECK_ERROR(glBindTexture(m_target, m_gl_tex));
 
 		if (m_array_size > 1)
@@ -448,6 +534,22 @@ namespace dw
 				height = std::max(1, (height / 2));
 			}
 
+#if !defined(__EMSCRIPTEN__)
+			if (dsa_supported())
+			{
+				if (m_array_size > 1)
+				{
+					GL_CHECK_ERROR(glTextureSubImage3D(m_gl_tex, mip_level, 0, 0, array_index, width, height, 1, m_format, m_type, data));
+				}
+				else
+				{
+					GL_CHECK_ERROR(glTextureSubImage2D(m_gl_tex, mip_level, 0, 0, width, height, m_format, m_type, data));
+				}
+
+				return;
+			}
+#endif
+
 			GL_CHECK_ERROR(glBindTexture(m_target, m_gl_tex));
 
 			if (m_array_size > 1)
@@ -567,6 +669,14 @@ namespace dw
 			depth = std::max(1, (depth / 2));
 		}
 
+#if !defined(__EMSCRIPTEN__)
+		if (dsa_supported())
+		{
+			GL_CHECK_ERROR(glTextureSubImage3D(m_gl_tex, mip_level, 0, 0, 0, width, height, depth, m_format, m_type, data));
+			return;
+		}
+#endif
+
 		GL_CHECK_ERROR(glBindTexture(m_target, m_gl_tex));
 		GL_CHECK_ERROR(glTexImage3D(m_target, mip_level, m_internal_format, width, height, depth, 0, m_format, m_type, data));
 		GL_CHECK_ERROR(glBindTexture(m_target, 0));
@@ -780,6 +890,13 @@ namespace dw
 		}
 
 #if !defined(__EMSCRIPTEN__)
+		if (dsa_supported())
+		{
+			// DSA addresses cubemap faces as layers, cubemap arrays as layer-faces.
+			GL_CHECK_ERROR(glTextureSubImage3D(m_gl_tex, mip_level, 0, 0, layer_index * 6 + face_index, width, height, 1, m_format, m_type, data));
+			return;
+		}
+
 		if (m_array_size > 1)
 		{
 			GL_CHECK_ERROR(glBindTexture(m_target, m_gl_tex));
@@ -818,8 +935,147 @@ namespace dw
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
 
+	bool SamplerDesc::operator==(const SamplerDesc& other) const
+	{
+		return min_filter == other.min_filter &&
+			   mag_filter == other.mag_filter &&
+			   wrap_s == other.wrap_s &&
+			   wrap_t == other.wrap_t &&
+			   wrap_r == other.wrap_r &&
+			   compare_mode == other.compare_mode &&
+			   compare_func == other.compare_func &&
+			   max_anisotropy == other.max_anisotropy &&
+			   border_color == other.border_color;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	size_t SamplerDescHash::operator()(const SamplerDesc& desc) const
+	{
+		size_t hash = 0;
+
+		auto combine = [&hash](size_t value) { hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+
+		combine(desc.min_filter);
+		combine(desc.mag_filter);
+		combine(desc.wrap_s);
+		combine(desc.wrap_t);
+		combine(desc.wrap_r);
+		combine(desc.compare_mode);
+		combine(desc.compare_func);
+		combine(std::hash<float>()(desc.max_anisotropy));
+
+		for (int i = 0; i < 4; i++)
+			combine(std::hash<float>()(desc.border_color[i]));
+
+		return hash;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	std::unordered_map<SamplerDesc, std::unique_ptr<Sampler>, SamplerDescHash> Sampler::m_cache;
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	Sampler* Sampler::get(const SamplerDesc& desc)
+	{
+		auto itr = m_cache.find(desc);
+
+		if (itr != m_cache.end())
+			return itr->second.get();
+
+		Sampler* sampler = new Sampler(desc);
+		m_cache[desc] = std::unique_ptr<Sampler>(sampler);
+
+		return sampler;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void Sampler::clear_cache()
+	{
+		m_cache.clear();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	Sampler::Sampler(const SamplerDesc& desc) : m_desc(desc)
+	{
+		GL_CHECK_ERROR(glGenSamplers(1, &m_gl_sampler));
+
+		GL_CHECK_ERROR(glSamplerParameteri(m_gl_sampler, GL_TEXTURE_MIN_FILTER, desc.min_filter));
+		GL_CHECK_ERROR(glSamplerParameteri(m_gl_sampler, GL_TEXTURE_MAG_FILTER, desc.mag_filter));
+		GL_CHECK_ERROR(glSamplerParameteri(m_gl_sampler, GL_TEXTURE_WRAP_S, desc.wrap_s));
+		GL_CHECK_ERROR(glSamplerParameteri(m_gl_sampler, GL_TEXTURE_WRAP_T, desc.wrap_t));
+		GL_CHECK_ERROR(glSamplerParameteri(m_gl_sampler, GL_TEXTURE_WRAP_R, desc.wrap_r));
+		GL_CHECK_ERROR(glSamplerParameteri(m_gl_sampler, GL_TEXTURE_COMPARE_MODE, desc.compare_mode));
+		GL_CHECK_ERROR(glSamplerParameteri(m_gl_sampler, GL_TEXTURE_COMPARE_FUNC, desc.compare_func));
+
+#if !defined(__EMSCRIPTEN__)
+		GL_CHECK_ERROR(glSamplerParameterfv(m_gl_sampler, GL_TEXTURE_BORDER_COLOR, &desc.border_color[0]));
+
+		if (desc.max_anisotropy > 1.0f)
+		{
+			if (GLAD_GL_VERSION_4_6 || GLAD_GL_ARB_texture_filter_anisotropic || GLAD_GL_EXT_texture_filter_anisotropic)
+			{
+				float max_anisotropy = 1.0f;
+				GL_CHECK_ERROR(glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &max_anisotropy));
+				GL_CHECK_ERROR(glSamplerParameterf(m_gl_sampler, GL_TEXTURE_MAX_ANISOTROPY, std::min(desc.max_anisotropy, max_anisotropy)));
+			}
+			else
+				DW_LOG_WARNING("OPENGL: Anisotropic filtering unsupported. Ignoring sampler max anisotropy.");
+		}
+#endif
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	Sampler::~Sampler()
+	{
+		GL_CHECK_ERROR(glDeleteSamplers(1, &m_gl_sampler));
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void Sampler::bind(uint32_t unit)
+	{
+		GL_CHECK_ERROR(glBindSampler(unit, m_gl_sampler));
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void Sampler::unbind(uint32_t unit)
+	{
+		GL_CHECK_ERROR(glBindSampler(unit, 0));
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	GLuint Sampler::id()
+	{
+		return m_gl_sampler;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	const SamplerDesc& Sampler::desc()
+	{
+		return m_desc;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
 	Framebuffer::Framebuffer()
 	{
+#if !defined(__EMSCRIPTEN__)
+		// Named framebuffer functions require the object to exist, which glGen* alone does not guarantee.
+		if (dsa_supported())
+		{
+			GL_CHECK_ERROR(glCreateFramebuffers(1, &m_gl_fbo));
+			return;
+		}
+#endif
+
 		GL_CHECK_ERROR(glGenFramebuffers(1, &m_gl_fbo));
 	}
 
@@ -848,6 +1104,28 @@ namespace dw
 
 	void Framebuffer::attach_render_target(uint32_t attachment, Texture* texture, uint32_t layer, uint32_t mip_level, bool draw, bool read)
 	{
+#if !defined(__EMSCRIPTEN__)
+		if (dsa_supported())
+		{
+			if (texture->array_size() > 1)
+			{
+				GL_CHECK_ERROR(glNamedFramebufferTextureLayer(m_gl_fbo, GL_COLOR_ATTACHMENT0 + attachment, texture->id(), mip_level, layer));
+			}
+			else
+			{
+				GL_CHECK_ERROR(glNamedFramebufferTexture(m_gl_fbo, GL_COLOR_ATTACHMENT0 + attachment, texture->id(), mip_level));
+			}
+
+			GL_CHECK_ERROR(glNamedFramebufferDrawBuffer(m_gl_fbo, draw ? GL_COLOR_ATTACHMENT0 + attachment : GL_NONE));
+			GL_CHECK_ERROR(glNamedFramebufferReadBuffer(m_gl_fbo, read ? GL_COLOR_ATTACHMENT0 + attachment : GL_NONE));
+
+			if (m_validation)
+				check_status();
+
+			return;
+		}
+#endif
+
 		glBindTexture(texture->target(), texture->id());
 		bind();
 
@@ -885,7 +1163,8 @@ namespace dw
 			GL_CHECK_ERROR(glReadBuffer(GL_NONE));
 		}
         
-        check_status();
+        if (m_validation)
+            check_status();
 
 		unbind();
 		glBindTexture(texture->target(), 0);
@@ -895,10 +1174,28 @@ namespace dw
 
 	void Framebuffer::attach_multiple_render_targets(uint32_t attachment_count, Texture** texture)
 	{
-		bind();
-
 		m_render_target_count = attachment_count;
 
+#if !defined(__EMSCRIPTEN__)
+		if (dsa_supported())
+		{
+			for (int i = 0; i < m_render_target_count; i++)
+			{
+				GL_CHECK_ERROR(glNamedFramebufferTexture(m_gl_fbo, GL_COLOR_ATTACHMENT0 + i, texture[i]->id(), 0));
+				m_attachments[i] = GL_COLOR_ATTACHMENT0 + i;
+			}
+
+			GL_CHECK_ERROR(glNamedFramebufferDrawBuffers(m_gl_fbo, m_render_target_count, m_attachments));
+
+			if (m_validation)
+				check_status();
+
+			return;
+		}
+#endif
+
+		bind();
+
 		for (int i = 0; i < m_render_target_count; i++)
 		{
 			glBindTexture(texture[i]->target(), texture[i]->id());
@@ -908,7 +1205,8 @@ namespace dw
 
 		glDrawBuffers(m_render_target_count, m_attachments);
 
-		check_status();
+		if (m_validation)
+			check_status();
 
 		unbind();
 	}
@@ -917,6 +1215,20 @@ namespace dw
 
 	void Framebuffer::attach_render_target(uint32_t attachment, TextureCube* texture, uint32_t face, uint32_t layer, uint32_t mip_level, bool draw, bool read)
 	{
+#if !defined(__EMSCRIPTEN__)
+		if (dsa_supported())
+		{
+			GL_CHECK_ERROR(glNamedFramebufferTextureLayer(m_gl_fbo, GL_COLOR_ATTACHMENT0 + attachment, texture->id(), mip_level, layer * 6 + face));
+			GL_CHECK_ERROR(glNamedFramebufferDrawBuffer(m_gl_fbo, draw ? GL_COLOR_ATTACHMENT0 + attachment : GL_NONE));
+			GL_CHECK_ERROR(glNamedFramebufferReadBuffer(m_gl_fbo, read ? GL_COLOR_ATTACHMENT0 + attachment : GL_NONE));
+
+			if (m_validation)
+				check_status();
+
+			return;
+		}
+#endif
+
 		glBindTexture(texture->target(), texture->id());
 		bind();
 
@@ -958,7 +1270,8 @@ namespace dw
 			GL_CHECK_ERROR(glReadBuffer(GL_NONE));
 		}
         
-        check_status();
+        if (m_validation)
+            check_status();
 
 		unbind();
 		glBindTexture(texture->target(), 0);
@@ -968,6 +1281,25 @@ namespace dw
 
 	void Framebuffer::attach_depth_stencil_target(Texture* texture, uint32_t layer, uint32_t mip_level)
 	{
+#if !defined(__EMSCRIPTEN__)
+		if (dsa_supported())
+		{
+			if (texture->array_size() > 1)
+			{
+				GL_CHECK_ERROR(glNamedFramebufferTextureLayer(m_gl_fbo, GL_DEPTH_ATTACHMENT, texture->id(), mip_level, layer));
+			}
+			else
+			{
+				GL_CHECK_ERROR(glNamedFramebufferTexture(m_gl_fbo, GL_DEPTH_ATTACHMENT, texture->id(), mip_level));
+			}
+
+			if (m_validation)
+				check_status();
+
+			return;
+		}
+#endif
+
 		glBindTexture(texture->target(), texture->id());
 		bind();
 
@@ -984,7 +1316,8 @@ namespace dw
 #endif
 		}
 
-        check_status();
+        if (m_validation)
+            check_status();
 
 		unbind();
 		glBindTexture(texture->target(), 0);
@@ -994,6 +1327,20 @@ namespace dw
 
 	void Framebuffer::attach_depth_stencil_target(TextureCube* texture, uint32_t face, uint32_t layer, uint32_t mip_level)
 	{
+#if !defined(__EMSCRIPTEN__)
+		if (dsa_supported())
+		{
+			GL_CHECK_ERROR(glNamedFramebufferTextureLayer(m_gl_fbo, GL_DEPTH_ATTACHMENT, texture->id(), mip_level, layer * 6 + face));
+			GL_CHECK_ERROR(glNamedFramebufferDrawBuffer(m_gl_fbo, GL_NONE));
+			GL_CHECK_ERROR(glNamedFramebufferReadBuffer(m_gl_fbo, GL_NONE));
+
+			if (m_validation)
+				check_status();
+
+			return;
+		}
+#endif
+
 		glBindTexture(texture->target(), texture->id());
 		bind();
 
@@ -1015,7 +1362,8 @@ namespace dw
 #endif
 		GL_CHECK_ERROR(glReadBuffer(GL_NONE));
         
-        check_status();
+        if (m_validation)
+            check_status();
 
 		unbind();
 		glBindTexture(texture->target(), 0);
@@ -1023,9 +1371,13 @@ namespace dw
     
     // -----------------------------------------------------------------------------------------------------------------------------------
     
-    void Framebuffer::check_status()
+    bool Framebuffer::check_status()
     {
+#if defined(__EMSCRIPTEN__)
         GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+#else
+        GLenum status = dsa_supported() ? glCheckNamedFramebufferStatus(m_gl_fbo, GL_FRAMEBUFFER) : glCheckFramebufferStatus(GL_FRAMEBUFFER);
+#endif
         
         if (status != GL_FRAMEBUFFER_COMPLETE)
         {
@@ -1065,7 +1417,11 @@ namespace dw
             }
             
             DW_LOG_ERROR(error);
+
+            return false;
         }
+
+        return true;
     }
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
@@ -1077,6 +1433,34 @@ namespace dw
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
 
+	GLuint Framebuffer::id()
+	{
+		return m_gl_fbo;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void Framebuffer::set_validation(bool enabled)
+	{
+		m_validation = enabled;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	bool Framebuffer::validate()
+	{
+		if (dsa_supported())
+			return check_status();
+
+		bind();
+		bool complete = check_status();
+		unbind();
+
+		return complete;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
     Shader* Shader::create_from_file(GLenum type, std::string path)
     {
         std::string source;
@@ -1100,6 +1484,8 @@ namespace dw
 	{
 		GL_CHECK_ERROR(m_gl_shader = glCreateShader(type));
 
+		parse_annotations(source);
+
 #if defined(__APPLE__)
 		source = "#version 410 core\n" + std::string(source);
 #elif defined(__EMSCRIPTEN__)
@@ -1154,31 +1540,87 @@ namespace dw
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
 
-	Program::Program(uint32_t count, Shader** shaders)
+	void Shader::parse_annotations(const std::string& source)
 	{
-#if !defined(__EMSCRIPTEN__)
-		if (count == 1 && shaders[0]->type() != GL_COMPUTE_SHADER)
+		std::istringstream stream(source);
+		std::string line;
+
+		while (std::getline(stream, line))
 		{
-			DW_LOG_ERROR("OPENGL: Compute shader programs can only have one shader.");
-			assert(false);
+			size_t comment = line.find("//#");
 
-			return;
-		}
-#endif
-		
-		GL_CHECK_ERROR(m_gl_program = glCreateProgram());
+			if (comment == std::string::npos)
+				continue;
 
-		for (int i = 0; i < count; i++)
-		{
-			GL_CHECK_ERROR(glAttachShader(m_gl_program, shaders[i]->m_gl_shader));
-		}
+			size_t uniform = line.find("uniform ");
 
-		GL_CHECK_ERROR(glLinkProgram(m_gl_program));
+			if (uniform == std::string::npos || uniform > comment)
+				continue;
 
-		GLint success;
-		char log[512];
+			std::istringstream annotation(line.substr(comment + 3));
+			std::istringstream declaration(line.substr(uniform + 8, comment - uniform - 8));
 
-		GL_CHECK_ERROR(glGetProgramiv(m_gl_program, GL_LINK_STATUS, &success));
+			std::string key;
+			int index = -1;
+			annotation >> key >> index;
+
+			if (index < 0)
+			{
+				DW_LOG_WARNING("OPENGL: Malformed shader annotation: " + line);
+				continue;
+			}
+
+			std::string name;
+
+			if (key == "binding")
+			{
+				// layout (std140) uniform <Block> //#binding N
+				declaration >> name;
+				name = name.substr(0, name.find_first_of("{;"));
+
+				if (!name.empty())
+					m_block_bindings[name] = index;
+			}
+			else if (key == "slot")
+			{
+				// uniform <sampler type> <name>; //#slot N
+				std::string sampler_type;
+				declaration >> sampler_type >> name;
+				name = name.substr(0, name.find_first_of(";["));
+
+				if (!name.empty())
+					m_sampler_slots[name] = index;
+			}
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	Program::Program(uint32_t count, Shader** shaders)
+	{
+#if !defined(__EMSCRIPTEN__)
+		if (count == 1 && shaders[0]->type() != GL_COMPUTE_SHADER)
+		{
+			DW_LOG_ERROR("OPENGL: Compute shader programs can only have one shader.");
+			assert(false);
+
+			return;
+		}
+#endif
+		
+		GL_CHECK_ERROR(m_gl_program = glCreateProgram());
+
+		for (int i = 0; i < count; i++)
+		{
+			GL_CHECK_ERROR(glAttachShader(m_gl_program, shaders[i]->m_gl_shader));
+		}
+
+		GL_CHECK_ERROR(glLinkProgram(m_gl_program));
+
+		GLint success;
+		char log[512];
+
+		GL_CHECK_ERROR(glGetProgramiv(m_gl_program, GL_LINK_STATUS, &success));
 
 		if (!success)
 		{
@@ -1210,6 +1652,36 @@ namespace dw
 				m_location_map[std::string(name)] = loc;
 		}
 
+		// Apply uniform block bindings and sampler units declared through shader annotations. Blocks and samplers
+		// that were optimized out of the linked program are silently skipped.
+		bool has_samplers = false;
+
+		for (int i = 0; i < count; i++)
+		{
+			for (auto& binding : shaders[i]->m_block_bindings)
+			{
+				GL_CHECK_ERROR(GLuint idx = glGetUniformBlockIndex(m_gl_program, binding.first.c_str()));
+
+				if (idx != GL_INVALID_INDEX)
+					GL_CHECK_ERROR(glUniformBlockBinding(m_gl_program, idx, binding.second));
+			}
+
+			has_samplers |= !shaders[i]->m_sampler_slots.empty();
+		}
+
+		if (has_samplers)
+		{
+			use();
+
+			for (int i = 0; i < count; i++)
+			{
+				for (auto& slot : shaders[i]->m_sampler_slots)
+					set_uniform(slot.first, slot.second);
+			}
+
+			GL_CHECK_ERROR(glUseProgram(0));
+		}
+
 #if defined(__EMSCRIPTEN__)
 		// Bind attributes in OpenGL ES/WebGL versions.
 
@@ -1257,6 +1729,18 @@ namespace dw
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
 
+	GLint Program::uniform_location(const std::string& name)
+	{
+		auto it = m_location_map.find(name);
+
+		if (it == m_location_map.end())
+			return -1;
+
+		return GLint(it->second);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
 	bool Program::set_uniform(std::string name, int value)
 	{
 		if (m_location_map.find(name) == m_location_map.end())
@@ -1451,6 +1935,15 @@ namespace dw
 
 	Buffer::Buffer(GLenum type, GLenum usage, size_t size, void* data) : m_type(type), m_size(size)
 	{
+#if !defined(__EMSCRIPTEN__)
+		if (dsa_supported())
+		{
+			GL_CHECK_ERROR(glCreateBuffers(1, &m_gl_buffer));
+			GL_CHECK_ERROR(glNamedBufferData(m_gl_buffer, size, data, usage));
+			return;
+		}
+#endif
+
 		GL_CHECK_ERROR(glGenBuffers(1, &m_gl_buffer));
 
 		GL_CHECK_ERROR(glBindBuffer(m_type, m_gl_buffer));
@@ -1464,6 +1957,25 @@ namespace dw
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
 
+	Buffer::Buffer(GLenum type, size_t size) : m_type(type), m_size(size)
+	{
+#if defined(__EMSCRIPTEN__)
+		GL_CHECK_ERROR(glGenBuffers(1, &m_gl_buffer));
+		m_staging = nullptr;
+#else
+		if (dsa_supported())
+		{
+			GL_CHECK_ERROR(glCreateBuffers(1, &m_gl_buffer));
+		}
+		else
+		{
+			GL_CHECK_ERROR(glGenBuffers(1, &m_gl_buffer));
+		}
+#endif
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
 	Buffer::~Buffer()
 	{
 #if defined(__EMSCRIPTEN__)
@@ -1509,6 +2021,12 @@ namespace dw
 		m_mapped_offset = 0;
 		return m_staging;
 #else
+		if (dsa_supported())
+		{
+			GL_CHECK_ERROR(void* ptr = glMapNamedBuffer(m_gl_buffer, access));
+			return ptr;
+		}
+
 		GL_CHECK_ERROR(glBindBuffer(m_type, m_gl_buffer));
 		GL_CHECK_ERROR(void* ptr = glMapBuffer(m_type, access));
 		GL_CHECK_ERROR(glBindBuffer(m_type, 0));
@@ -1525,6 +2043,12 @@ namespace dw
 		m_mapped_offset = offset;
 		return static_cast<char*>(m_staging) + offset;
 #else
+		if (dsa_supported())
+		{
+			GL_CHECK_ERROR(void* ptr = glMapNamedBufferRange(m_gl_buffer, offset, size, access));
+			return ptr;
+		}
+
 		GL_CHECK_ERROR(glBindBuffer(m_type, m_gl_buffer));
 		GL_CHECK_ERROR(void* ptr = glMapBufferRange(m_type, offset, size, access));
 		GL_CHECK_ERROR(glBindBuffer(m_type, 0));
@@ -1541,6 +2065,12 @@ namespace dw
 		glBufferSubData(m_type, m_mapped_offset, m_mapped_size, static_cast<char*>(m_staging) + m_mapped_offset);
 		GL_CHECK_ERROR(glBindBuffer(m_type, 0));
 #else
+		if (dsa_supported())
+		{
+			GL_CHECK_ERROR(glUnmapNamedBuffer(m_gl_buffer));
+			return;
+		}
+
 		GL_CHECK_ERROR(glBindBuffer(m_type, m_gl_buffer));
 		GL_CHECK_ERROR(glUnmapBuffer(m_type));
 		GL_CHECK_ERROR(glBindBuffer(m_type, 0));
@@ -1551,6 +2081,14 @@ namespace dw
 
 	void Buffer::set_data(size_t offset, size_t size, void* data)
 	{
+#if !defined(__EMSCRIPTEN__)
+		if (dsa_supported())
+		{
+			GL_CHECK_ERROR(glNamedBufferSubData(m_gl_buffer, offset, size, data));
+			return;
+		}
+#endif
+
 		GL_CHECK_ERROR(glBindBuffer(m_type, m_gl_buffer));
 		glBufferSubData(m_type, offset, size, data);
 		GL_CHECK_ERROR(glBindBuffer(m_type, 0));
@@ -1558,6 +2096,20 @@ namespace dw
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
 
+	GLuint Buffer::id()
+	{
+		return m_gl_buffer;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	size_t Buffer::size()
+	{
+		return m_size;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
     VertexBuffer::VertexBuffer(GLenum usage, size_t size, void* data) : Buffer(GL_ARRAY_BUFFER, usage, size, data) {}
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
@@ -1592,8 +2144,258 @@ namespace dw
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
 
-	VertexArray::VertexArray(VertexBuffer* vbo, IndexBuffer* ibo, size_t vertex_size, int attrib_count, VertexAttrib attribs[])
+	StreamBuffer::StreamBuffer(GLenum type, size_t size, uint32_t num_frames) : Buffer(type, 0), m_num_frames(num_frames), m_current_frame(num_frames - 1)
+	{
+		// Every region must start at an offset usable with glBindBufferRange.
+		GLint alignment = 0;
+		GL_CHECK_ERROR(glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment));
+		alignment = std::max(alignment, 256);
+
+		m_region_size = ((size + alignment - 1) / alignment) * alignment;
+		m_size = m_region_size * m_num_frames;
+		m_fences.resize(m_num_frames, nullptr);
+
+#if defined(__EMSCRIPTEN__)
+		m_persistent = false;
+#else
+		m_persistent = GLAD_GL_VERSION_4_4 != 0;
+
+		if (dsa_supported())
+		{
+			GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+			GL_CHECK_ERROR(glNamedBufferStorage(m_gl_buffer, m_size, nullptr, flags));
+			GL_CHECK_ERROR(m_ptr = static_cast<uint8_t*>(glMapNamedBufferRange(m_gl_buffer, 0, m_size, flags)));
+			return;
+		}
+#endif
+
+		GL_CHECK_ERROR(glBindBuffer(m_type, m_gl_buffer));
+
+#if !defined(__EMSCRIPTEN__)
+		if (m_persistent)
+		{
+			GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+			GL_CHECK_ERROR(glBufferStorage(m_type, m_size, nullptr, flags));
+			GL_CHECK_ERROR(m_ptr = static_cast<uint8_t*>(glMapBufferRange(m_type, 0, m_size, flags)));
+		}
+		else
+#endif
+		{
+			DW_LOG_WARNING("OPENGL: glBufferStorage unavailable. StreamBuffer falling back to glBufferSubData uploads.");
+
+			GL_CHECK_ERROR(glBufferData(m_type, m_size, nullptr, GL_STREAM_DRAW));
+			m_ptr = static_cast<uint8_t*>(malloc(m_size));
+		}
+
+		GL_CHECK_ERROR(glBindBuffer(m_type, 0));
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	StreamBuffer::~StreamBuffer()
 	{
+		for (auto& fence : m_fences)
+		{
+			if (fence)
+				glDeleteSync(fence);
+		}
+
+#if !defined(__EMSCRIPTEN__)
+		if (m_persistent && dsa_supported())
+		{
+			GL_CHECK_ERROR(glUnmapNamedBuffer(m_gl_buffer));
+		}
+		else if (m_persistent)
+		{
+			GL_CHECK_ERROR(glBindBuffer(m_type, m_gl_buffer));
+			GL_CHECK_ERROR(glUnmapBuffer(m_type));
+			GL_CHECK_ERROR(glBindBuffer(m_type, 0));
+		}
+		else
+#endif
+			free(m_ptr);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void StreamBuffer::begin_frame()
+	{
+		m_current_frame = (m_current_frame + 1) % m_num_frames;
+		m_head = 0;
+		m_flushed = 0;
+
+		GLsync& fence = m_fences[m_current_frame];
+
+		if (fence)
+		{
+			while (true)
+			{
+				GL_CHECK_ERROR(GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000));
+
+				if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+					break;
+
+				if (result == GL_WAIT_FAILED)
+				{
+					DW_LOG_ERROR("OPENGL: glClientWaitSync failed on StreamBuffer region.");
+					break;
+				}
+			}
+
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void StreamBuffer::end_frame()
+	{
+		flush();
+
+		if (m_persistent)
+		{
+			GL_CHECK_ERROR(m_fences[m_current_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void* StreamBuffer::allocate(size_t size, size_t alignment, size_t& offset)
+	{
+		// Align the offset from the start of the buffer, since region sizes need not be a multiple of the alignment.
+		size_t base = m_current_frame * m_region_size;
+		size_t start = ((base + m_head + alignment - 1) / alignment) * alignment - base;
+
+		if (start + size > m_region_size)
+		{
+			DW_LOG_ERROR("OPENGL: StreamBuffer region out of memory.");
+			return nullptr;
+		}
+
+		m_head = start + size;
+		offset = base + start;
+
+		return m_ptr + offset;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void StreamBuffer::flush()
+	{
+		if (m_persistent || m_head == m_flushed)
+			return;
+
+		size_t offset = m_current_frame * m_region_size + m_flushed;
+
+#if !defined(__EMSCRIPTEN__)
+		if (dsa_supported())
+		{
+			GL_CHECK_ERROR(glNamedBufferSubData(m_gl_buffer, offset, m_head - m_flushed, m_ptr + offset));
+			m_flushed = m_head;
+			return;
+		}
+#endif
+
+		GL_CHECK_ERROR(glBindBuffer(m_type, m_gl_buffer));
+		GL_CHECK_ERROR(glBufferSubData(m_type, offset, m_head - m_flushed, m_ptr + offset));
+		GL_CHECK_ERROR(glBindBuffer(m_type, 0));
+
+		m_flushed = m_head;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	size_t StreamBuffer::region_size()
+	{
+		return m_region_size;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	bool StreamBuffer::persistent()
+	{
+		return m_persistent;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	TransientUniformBuffer::TransientUniformBuffer(size_t size, uint32_t num_frames) : StreamBuffer(GL_UNIFORM_BUFFER, size, num_frames)
+	{
+		GLint alignment = 0;
+		GL_CHECK_ERROR(glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment));
+		m_alignment = std::max(alignment, 1);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	TransientUniformBuffer::~TransientUniformBuffer() {}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void* TransientUniformBuffer::allocate(size_t size, size_t& offset)
+	{
+		return StreamBuffer::allocate(size, m_alignment, offset);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	bool TransientUniformBuffer::push(const void* data, size_t size, size_t& offset)
+	{
+		void* ptr = allocate(size, offset);
+
+		if (!ptr)
+			return false;
+
+		memcpy(ptr, data, size);
+
+		return true;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	size_t TransientUniformBuffer::alignment()
+	{
+		return m_alignment;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	VertexArray::VertexArray(Buffer* vbo, IndexBuffer* ibo, size_t vertex_size, int attrib_count, VertexAttrib attribs[])
+	{
+#if !defined(__EMSCRIPTEN__)
+		if (dsa_supported())
+		{
+			GL_CHECK_ERROR(glCreateVertexArrays(1, &m_gl_vao));
+			GL_CHECK_ERROR(glVertexArrayVertexBuffer(m_gl_vao, 0, vbo->id(), 0, vertex_size));
+
+			if (ibo)
+			{
+				GL_CHECK_ERROR(glVertexArrayElementBuffer(m_gl_vao, ibo->id()));
+			}
+
+			for (uint32_t i = 0; i < attrib_count; i++)
+			{
+				GL_CHECK_ERROR(glEnableVertexArrayAttrib(m_gl_vao, i));
+
+				if (attribs[i].type == GL_INT)
+				{
+					GL_CHECK_ERROR(glVertexArrayAttribIFormat(m_gl_vao, i, attribs[i].num_sub_elements, attribs[i].type, attribs[i].offset));
+				}
+				else
+				{
+					GL_CHECK_ERROR(glVertexArrayAttribFormat(m_gl_vao, i, attribs[i].num_sub_elements, attribs[i].type, attribs[i].normalized, attribs[i].offset));
+				}
+
+				GL_CHECK_ERROR(glVertexArrayAttribBinding(m_gl_vao, i, 0));
+			}
+
+			return;
+		}
+#endif
+
 		GL_CHECK_ERROR(glGenVertexArrays(1, &m_gl_vao));
 		GL_CHECK_ERROR(glBindVertexArray(m_gl_vao));
 		vbo->bind();
@@ -1655,6 +2457,167 @@ namespace dw
 
 	// -----------------------------------------------------------------------------------------------------------------------------------
 
+	std::vector<std::unique_ptr<VertexFormat>> VertexFormat::m_cache;
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	bool VertexFormat::supported()
+	{
+#if defined(__EMSCRIPTEN__)
+		return false;
+#else
+		return GLAD_GL_VERSION_4_3 != 0;
+#endif
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	VertexFormat* VertexFormat::get(size_t vertex_size, int attrib_count, VertexAttrib attribs[])
+	{
+		// Only a handful of layouts exist in practice, so a linear search is enough.
+		for (auto& format : m_cache)
+		{
+			if (format->matches(vertex_size, attrib_count, attribs))
+				return format.get();
+		}
+
+		VertexFormat* format = new VertexFormat(vertex_size, attrib_count, attribs);
+		m_cache.push_back(std::unique_ptr<VertexFormat>(format));
+
+		return format;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void VertexFormat::clear_cache()
+	{
+		m_cache.clear();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	VertexFormat::VertexFormat(size_t vertex_size, int attrib_count, VertexAttrib attribs[]) : m_vertex_size(vertex_size), m_attribs(attribs, attribs + attrib_count)
+	{
+#if defined(__EMSCRIPTEN__)
+		DW_LOG_ERROR("WEBGL: Separate vertex formats unsupported!");
+#else
+		if (dsa_supported())
+		{
+			GL_CHECK_ERROR(glCreateVertexArrays(1, &m_gl_vao));
+
+			for (uint32_t i = 0; i < attrib_count; i++)
+			{
+				GL_CHECK_ERROR(glEnableVertexArrayAttrib(m_gl_vao, i));
+
+				if (attribs[i].type == GL_INT)
+				{
+					GL_CHECK_ERROR(glVertexArrayAttribIFormat(m_gl_vao, i, attribs[i].num_sub_elements, attribs[i].type, attribs[i].offset));
+				}
+				else
+				{
+					GL_CHECK_ERROR(glVertexArrayAttribFormat(m_gl_vao, i, attribs[i].num_sub_elements, attribs[i].type, attribs[i].normalized, attribs[i].offset));
+				}
+
+				GL_CHECK_ERROR(glVertexArrayAttribBinding(m_gl_vao, i, 0));
+			}
+
+			return;
+		}
+
+		GL_CHECK_ERROR(glGenVertexArrays(1, &m_gl_vao));
+		GL_CHECK_ERROR(glBindVertexArray(m_gl_vao));
+
+		for (uint32_t i = 0; i < attrib_count; i++)
+		{
+			GL_CHECK_ERROR(glEnableVertexAttribArray(i));
+
+			if (attribs[i].type == GL_INT)
+			{
+				GL_CHECK_ERROR(glVertexAttribIFormat(i, attribs[i].num_sub_elements, attribs[i].type, attribs[i].offset));
+			}
+			else
+			{
+				GL_CHECK_ERROR(glVertexAttribFormat(i, attribs[i].num_sub_elements, attribs[i].type, attribs[i].normalized, attribs[i].offset));
+			}
+
+			GL_CHECK_ERROR(glVertexAttribBinding(i, 0));
+		}
+
+		GL_CHECK_ERROR(glBindVertexArray(0));
+#endif
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	VertexFormat::~VertexFormat()
+	{
+#if !defined(__EMSCRIPTEN__)
+		glDeleteVertexArrays(1, &m_gl_vao);
+#endif
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void VertexFormat::bind()
+	{
+		GL_CHECK_ERROR(glBindVertexArray(m_gl_vao));
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void VertexFormat::unbind()
+	{
+		GL_CHECK_ERROR(glBindVertexArray(0));
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void VertexFormat::bind_buffers(Buffer* vbo, IndexBuffer* ibo, size_t offset)
+	{
+#if !defined(__EMSCRIPTEN__)
+		GL_CHECK_ERROR(glBindVertexBuffer(0, vbo->id(), offset, m_vertex_size));
+
+		// The element array binding is vertex array state, so this attaches the index buffer to the bound format.
+		if (ibo)
+			ibo->bind();
+#endif
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	GLuint VertexFormat::id()
+	{
+		return m_gl_vao;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	size_t VertexFormat::vertex_size()
+	{
+		return m_vertex_size;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	bool VertexFormat::matches(size_t vertex_size, int attrib_count, VertexAttrib attribs[])
+	{
+		if (vertex_size != m_vertex_size || attrib_count != m_attribs.size())
+			return false;
+
+		for (int i = 0; i < attrib_count; i++)
+		{
+			if (attribs[i].num_sub_elements != m_attribs[i].num_sub_elements ||
+				attribs[i].type != m_attribs[i].type ||
+				attribs[i].normalized != m_attribs[i].normalized ||
+				attribs[i].offset != m_attribs[i].offset)
+				return false;
+		}
+
+		return true;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
 	Query::Query()
 	{
 		GL_CHECK_ERROR(glGenQueries(1, &m_query));
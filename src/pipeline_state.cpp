@@ -0,0 +1,204 @@
+#include <pipeline_state.h>
+#include <initializer_list>
+
+namespace dw
+{
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	static uint64_t hash_values(std::initializer_list<uint64_t> values)
+	{
+		// FNV-1a.
+		uint64_t hash = 14695981039346656037ull;
+
+		for (auto value : values)
+		{
+			hash ^= value;
+			hash *= 1099511628211ull;
+		}
+
+		return hash;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	PipelineState::PipelineState(const PipelineStateDesc& desc) : m_desc(desc)
+	{
+		const BlendState&  blend = desc.blend;
+		const DepthState&  depth = desc.depth;
+		const RasterState& raster = desc.raster;
+		const CullState&   cull = desc.cull;
+
+		m_blend_hash = hash_values({ blend.enable, blend.src_rgb, blend.dst_rgb, blend.src_alpha, blend.dst_alpha, blend.op_rgb, blend.op_alpha });
+		m_depth_hash = hash_values({ depth.test, depth.write, depth.func });
+#if defined(__EMSCRIPTEN__)
+		m_raster_hash = hash_values({ raster.front_face, raster.scissor });
+#else
+		m_raster_hash = hash_values({ raster.polygon_mode, raster.front_face, raster.scissor });
+#endif
+		m_cull_hash = hash_values({ cull.enable, cull.face });
+		m_hash = hash_values({ uint64_t(uintptr_t(desc.program)), uint64_t(uintptr_t(desc.vertex_array)), m_blend_hash, m_depth_hash, m_raster_hash, m_cull_hash });
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	PipelineState::~PipelineState() {}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	PipelineStateBinder::PipelineStateBinder() {}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	PipelineStateBinder::~PipelineStateBinder() {}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void PipelineStateBinder::bind(PipelineState* pso)
+	{
+		if (pso == m_current)
+			return;
+
+		const PipelineStateDesc& desc = pso->desc();
+		PipelineState*			 previous = m_current;
+
+		if (!previous || previous->desc().program != desc.program)
+		{
+			if (desc.program)
+				desc.program->use();
+		}
+
+		if (!previous || previous->desc().vertex_array != desc.vertex_array)
+		{
+			if (desc.vertex_array)
+				desc.vertex_array->bind();
+		}
+
+		if (!previous || previous->blend_hash() != pso->blend_hash())
+			apply_blend(desc.blend, previous ? &previous->desc().blend : nullptr);
+
+		if (!previous || previous->depth_hash() != pso->depth_hash())
+			apply_depth(desc.depth, previous ? &previous->desc().depth : nullptr);
+
+		if (!previous || previous->raster_hash() != pso->raster_hash())
+			apply_raster(desc.raster, previous ? &previous->desc().raster : nullptr);
+
+		if (!previous || previous->cull_hash() != pso->cull_hash())
+			apply_cull(desc.cull, previous ? &previous->desc().cull : nullptr);
+
+		m_current = pso;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void PipelineStateBinder::invalidate()
+	{
+		m_current = nullptr;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void PipelineStateBinder::apply_blend(const BlendState& state, const BlendState* previous)
+	{
+		if (!previous || previous->enable != state.enable)
+		{
+			if (state.enable)
+			{
+				GL_CHECK_ERROR(glEnable(GL_BLEND));
+			}
+			else
+			{
+				GL_CHECK_ERROR(glDisable(GL_BLEND));
+			}
+		}
+
+		if (!previous || previous->src_rgb != state.src_rgb || previous->dst_rgb != state.dst_rgb || previous->src_alpha != state.src_alpha || previous->dst_alpha != state.dst_alpha)
+		{
+			GL_CHECK_ERROR(glBlendFuncSeparate(state.src_rgb, state.dst_rgb, state.src_alpha, state.dst_alpha));
+		}
+
+		if (!previous || previous->op_rgb != state.op_rgb || previous->op_alpha != state.op_alpha)
+		{
+			GL_CHECK_ERROR(glBlendEquationSeparate(state.op_rgb, state.op_alpha));
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void PipelineStateBinder::apply_depth(const DepthState& state, const DepthState* previous)
+	{
+		if (!previous || previous->test != state.test)
+		{
+			if (state.test)
+			{
+				GL_CHECK_ERROR(glEnable(GL_DEPTH_TEST));
+			}
+			else
+			{
+				GL_CHECK_ERROR(glDisable(GL_DEPTH_TEST));
+			}
+		}
+
+		if (!previous || previous->write != state.write)
+		{
+			GL_CHECK_ERROR(glDepthMask(state.write ? GL_TRUE : GL_FALSE));
+		}
+
+		if (!previous || previous->func != state.func)
+		{
+			GL_CHECK_ERROR(glDepthFunc(state.func));
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void PipelineStateBinder::apply_raster(const RasterState& state, const RasterState* previous)
+	{
+#if !defined(__EMSCRIPTEN__)
+		if (!previous || previous->polygon_mode != state.polygon_mode)
+		{
+			GL_CHECK_ERROR(glPolygonMode(GL_FRONT_AND_BACK, state.polygon_mode));
+		}
+#endif
+
+		if (!previous || previous->front_face != state.front_face)
+		{
+			GL_CHECK_ERROR(glFrontFace(state.front_face));
+		}
+
+		if (!previous || previous->scissor != state.scissor)
+		{
+			if (state.scissor)
+			{
+				GL_CHECK_ERROR(glEnable(GL_SCISSOR_TEST));
+			}
+			else
+			{
+				GL_CHECK_ERROR(glDisable(GL_SCISSOR_TEST));
+			}
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void PipelineStateBinder::apply_cull(const CullState& state, const CullState* previous)
+	{
+		if (!previous || previous->enable != state.enable)
+		{
+			if (state.enable)
+			{
+				GL_CHECK_ERROR(glEnable(GL_CULL_FACE));
+			}
+			else
+			{
+				GL_CHECK_ERROR(glDisable(GL_CULL_FACE));
+			}
+		}
+
+		if (!previous || previous->face != state.face)
+		{
+			GL_CHECK_ERROR(glCullFace(state.face));
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+} // namespace dw
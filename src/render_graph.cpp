@@ -0,0 +1,359 @@
+#include <render_graph.h>
+#include <logger.h>
+#include <algorithm>
+
+namespace dw
+{
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	RenderGraphBuilder::RenderGraphBuilder(RenderGraph* graph, uint32_t pass) : m_graph(graph), m_pass(pass) {}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	RenderGraphResource RenderGraphBuilder::create(const std::string& name, const RenderTargetDesc& desc)
+	{
+		RenderGraph::Resource resource;
+
+		resource.name = name;
+		resource.desc = desc;
+
+		m_graph->m_resources.push_back(resource);
+
+		return m_graph->m_resources.size() - 1;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	RenderGraphResource RenderGraphBuilder::read(RenderGraphResource resource, RenderGraphUsage usage)
+	{
+		if (!m_graph->valid(resource))
+			return RENDER_GRAPH_INVALID_RESOURCE;
+
+		m_graph->m_passes[m_pass].reads.push_back({ resource, usage });
+
+		return resource;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	RenderGraphResource RenderGraphBuilder::write(RenderGraphResource resource, RenderGraphUsage usage)
+	{
+		if (!m_graph->valid(resource))
+			return RENDER_GRAPH_INVALID_RESOURCE;
+
+		if (usage == RENDER_GRAPH_USAGE_SAMPLED)
+		{
+			DW_LOG_ERROR("RenderGraph: Resources cannot be written through a sampler.");
+			return RENDER_GRAPH_INVALID_RESOURCE;
+		}
+
+		m_graph->m_passes[m_pass].writes.push_back({ resource, usage });
+		m_graph->m_resources[resource].writers.push_back(m_pass);
+
+		return resource;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void RenderGraphBuilder::side_effect()
+	{
+		m_graph->m_passes[m_pass].side_effect = true;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	RenderGraphContext::RenderGraphContext(RenderGraph* graph, uint32_t pass) : m_graph(graph), m_pass(pass) {}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	Texture2D* RenderGraphContext::texture(RenderGraphResource resource)
+	{
+		if (!m_graph->valid(resource))
+			return nullptr;
+
+		return m_graph->m_resources[resource].texture;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	Framebuffer* RenderGraphContext::framebuffer()
+	{
+		RenderGraph::Pass& pass = m_graph->m_passes[m_pass];
+
+		Texture2D* color[16];
+		uint32_t   color_count = 0;
+		Texture2D* depth = nullptr;
+
+		for (auto& access : pass.writes)
+		{
+			if (access.usage == RENDER_GRAPH_USAGE_RENDER_TARGET && color_count < 16)
+				color[color_count++] = m_graph->m_resources[access.resource].texture;
+			else if (access.usage == RENDER_GRAPH_USAGE_DEPTH_STENCIL)
+				depth = m_graph->m_resources[access.resource].texture;
+		}
+
+		// Depth can be bound read-only for depth testing without writing.
+		if (!depth)
+		{
+			for (auto& access : pass.reads)
+			{
+				if (access.usage == RENDER_GRAPH_USAGE_DEPTH_STENCIL)
+					depth = m_graph->m_resources[access.resource].texture;
+			}
+		}
+
+		if (color_count == 0 && !depth)
+			return nullptr;
+
+		return m_graph->m_pool->framebuffer(color_count, color, depth);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	RenderGraph::RenderGraph(RenderTargetPool* pool) : m_pool(pool) {}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	RenderGraph::~RenderGraph() {}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	RenderGraphResource RenderGraph::import(const std::string& name, Texture2D* texture)
+	{
+		Resource resource;
+
+		resource.name = name;
+		resource.texture = texture;
+		resource.imported = true;
+
+		m_resources.push_back(resource);
+		m_compiled = false;
+
+		return m_resources.size() - 1;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void RenderGraph::add_pass(const std::string& name, std::function<void(RenderGraphBuilder&)> setup, std::function<void(RenderGraphContext&)> execute)
+	{
+		Pass pass;
+
+		pass.name = name;
+		pass.execute = execute;
+
+		m_passes.push_back(pass);
+		m_compiled = false;
+
+		RenderGraphBuilder builder(this, m_passes.size() - 1);
+		setup(builder);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void RenderGraph::compile()
+	{
+		// Culling: walk backwards from passes with externally visible results, keeping every pass that produced something
+		// they consume. Writes also depend on earlier writers since a pass may load or blend onto previous contents.
+		std::vector<uint32_t> stack;
+
+		for (uint32_t i = 0; i < m_passes.size(); i++)
+		{
+			Pass& pass = m_passes[i];
+
+			pass.culled = true;
+			pass.barriers = 0;
+			pass.acquire.clear();
+			pass.release.clear();
+
+			bool root = pass.side_effect;
+
+			for (auto& access : pass.writes)
+				root |= m_resources[access.resource].imported;
+
+			if (root)
+			{
+				pass.culled = false;
+				stack.push_back(i);
+			}
+		}
+
+		while (!stack.empty())
+		{
+			uint32_t index = stack.back();
+			stack.pop_back();
+
+			Pass& pass = m_passes[index];
+
+			for (int list = 0; list < 2; list++)
+			{
+				for (auto& access : list == 0 ? pass.reads : pass.writes)
+				{
+					for (auto writer : m_resources[access.resource].writers)
+					{
+						if (writer < index && m_passes[writer].culled)
+						{
+							m_passes[writer].culled = false;
+							stack.push_back(writer);
+						}
+					}
+				}
+			}
+		}
+
+		// Lifetimes: transient resources are acquired before their first surviving use and released after the last one.
+		std::vector<uint32_t> first(m_resources.size(), UINT32_MAX);
+		std::vector<uint32_t> last(m_resources.size(), 0);
+
+		for (uint32_t i = 0; i < m_passes.size(); i++)
+		{
+			Pass& pass = m_passes[i];
+
+			if (pass.culled)
+				continue;
+
+			for (int list = 0; list < 2; list++)
+			{
+				for (auto& access : list == 0 ? pass.reads : pass.writes)
+				{
+					first[access.resource] = std::min(first[access.resource], i);
+					last[access.resource] = std::max(last[access.resource], i);
+				}
+			}
+		}
+
+		for (uint32_t i = 0; i < m_resources.size(); i++)
+		{
+			if (m_resources[i].imported || first[i] == UINT32_MAX)
+				continue;
+
+			m_passes[first[i]].acquire.push_back(i);
+			m_passes[last[i]].release.push_back(i);
+		}
+
+		// Barriers: only image stores are incoherent, so a barrier is needed when a later pass accesses a resource last
+		// written through an image. Each access type is synchronized once per write.
+		std::vector<bool>		image_written(m_resources.size(), false);
+		std::vector<GLbitfield> synchronized(m_resources.size(), 0);
+
+		for (auto& pass : m_passes)
+		{
+			if (pass.culled)
+				continue;
+
+			for (int list = 0; list < 2; list++)
+			{
+				for (auto& access : list == 0 ? pass.reads : pass.writes)
+				{
+					if (!image_written[access.resource])
+						continue;
+
+					GLbitfield bit = 0;
+
+#if !defined(__EMSCRIPTEN__)
+					if (access.usage == RENDER_GRAPH_USAGE_SAMPLED)
+						bit = GL_TEXTURE_FETCH_BARRIER_BIT;
+					else if (access.usage == RENDER_GRAPH_USAGE_IMAGE)
+						bit = GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+					else
+						bit = GL_FRAMEBUFFER_BARRIER_BIT;
+#endif
+
+					if (!(synchronized[access.resource] & bit))
+					{
+						pass.barriers |= bit;
+						synchronized[access.resource] |= bit;
+					}
+				}
+			}
+
+			for (auto& access : pass.writes)
+			{
+				image_written[access.resource] = access.usage == RENDER_GRAPH_USAGE_IMAGE;
+				synchronized[access.resource] = 0;
+			}
+		}
+
+		m_compiled = true;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void RenderGraph::execute()
+	{
+		if (!m_compiled)
+			compile();
+
+		for (uint32_t i = 0; i < m_passes.size(); i++)
+		{
+			Pass& pass = m_passes[i];
+
+			if (pass.culled)
+				continue;
+
+			for (auto resource : pass.acquire)
+				m_resources[resource].texture = m_pool->acquire(m_resources[resource].desc);
+
+#if !defined(__EMSCRIPTEN__)
+			if (pass.barriers != 0)
+			{
+				GL_CHECK_ERROR(glMemoryBarrier(pass.barriers));
+			}
+#endif
+
+			RenderGraphContext context(this, i);
+			pass.execute(context);
+
+			for (auto resource : pass.release)
+			{
+				m_pool->release(m_resources[resource].texture);
+				m_resources[resource].texture = nullptr;
+			}
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void RenderGraph::reset()
+	{
+		m_passes.clear();
+		m_resources.clear();
+		m_compiled = false;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	uint32_t RenderGraph::pass_count()
+	{
+		return m_passes.size();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	uint32_t RenderGraph::culled_pass_count()
+	{
+		uint32_t count = 0;
+
+		for (auto& pass : m_passes)
+		{
+			if (pass.culled)
+				count++;
+		}
+
+		return count;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	bool RenderGraph::valid(RenderGraphResource resource)
+	{
+		if (resource >= m_resources.size())
+		{
+			DW_LOG_ERROR("RenderGraph: Invalid resource handle.");
+			return false;
+		}
+
+		return true;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+} // namespace dw
@@ -0,0 +1,240 @@
+#include <render_queue.h>
+#include <mesh.h>
+#include <material.h>
+#include <algorithm>
+
+namespace dw
+{
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	RenderQueue::RenderQueue(uint32_t initial_capacity)
+	{
+		m_items.reserve(initial_capacity);
+		m_sorted_items.reserve(initial_capacity);
+		m_entries.reserve(initial_capacity);
+		m_scratch.reserve(initial_capacity);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	RenderQueue::~RenderQueue() {}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void RenderQueue::set_depth_range(float near, float far)
+	{
+		m_near = near;
+		m_far = far;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void RenderQueue::set_opaque_depth_buckets(uint32_t count)
+	{
+		m_depth_buckets = std::min(std::max(count, 1u), 16u);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void RenderQueue::clear()
+	{
+		m_items.clear();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void RenderQueue::push(RenderPass pass, Program* program, Mesh* mesh, uint32_t sub_mesh, float distance, uint32_t user_data)
+	{
+		RenderItem item;
+
+		item.program = program;
+		item.mesh = mesh;
+		item.sub_mesh = sub_mesh;
+		item.material = mesh->sub_meshes()[sub_mesh].mat;
+		item.user_data = user_data;
+		item.key = make_key(pass, program, mesh, item.material, distance);
+
+		m_items.push_back(item);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void RenderQueue::sort()
+	{
+		size_t count = m_items.size();
+
+		if (count < 2)
+			return;
+
+		m_entries.resize(count);
+		m_scratch.resize(count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			m_entries[i].key = m_items[i].key;
+			m_entries[i].index = i;
+		}
+
+		// LSD radix sort, one byte per pass. Passes where every key shares the same byte are skipped.
+		for (uint32_t shift = 0; shift < 64; shift += 8)
+		{
+			uint32_t histogram[256] = { 0 };
+
+			for (size_t i = 0; i < count; i++)
+				histogram[(m_entries[i].key >> shift) & 0xFF]++;
+
+			if (histogram[(m_entries[0].key >> shift) & 0xFF] == count)
+				continue;
+
+			uint32_t offset = 0;
+
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				uint32_t c = histogram[i];
+				histogram[i] = offset;
+				offset += c;
+			}
+
+			for (size_t i = 0; i < count; i++)
+				m_scratch[histogram[(m_entries[i].key >> shift) & 0xFF]++] = m_entries[i];
+
+			m_entries.swap(m_scratch);
+		}
+
+		m_sorted_items.resize(count);
+
+		for (size_t i = 0; i < count; i++)
+			m_sorted_items[i] = m_items[m_entries[i].index];
+
+		m_items.swap(m_sorted_items);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void RenderQueue::submit(std::function<void(const RenderItem&)> per_draw)
+	{
+		Program* current_program = nullptr;
+		VertexArray* current_vao = nullptr;
+		VertexFormat* current_format = nullptr;
+		Buffer* current_vbo = nullptr;
+		bool use_vertex_format = VertexFormat::supported();
+		Material* current_material = nullptr;
+
+		for (auto& item : m_items)
+		{
+			if (item.program != current_program)
+			{
+				item.program->use();
+				current_program = item.program;
+			}
+
+			if (use_vertex_format)
+			{
+				// One vertex array per layout. Switching meshes only swaps buffers.
+				VertexFormat* format = item.mesh->vertex_format();
+
+				if (format != current_format)
+				{
+					format->bind();
+					current_format = format;
+					current_vbo = nullptr;
+				}
+
+				Buffer* vbo = item.mesh->mesh_vertex_buffer();
+
+				if (vbo != current_vbo)
+				{
+					format->bind_buffers(vbo, item.mesh->mesh_index_buffer());
+					current_vbo = vbo;
+				}
+			}
+			else
+			{
+				VertexArray* vao = item.mesh->mesh_vertex_array();
+
+				if (vao != current_vao)
+				{
+					vao->bind();
+					current_vao = vao;
+				}
+			}
+
+			if (item.material && item.material != current_material)
+			{
+				for (uint32_t i = 0; i < 16; i++)
+				{
+					if (item.material->texture(i))
+					{
+						item.material->texture(i)->bind(i);
+
+						if (item.material->sampler(i))
+							item.material->sampler(i)->bind(i);
+					}
+				}
+
+				current_material = item.material;
+			}
+
+			if (per_draw)
+				per_draw(item);
+
+			SubMesh& submesh = item.mesh->sub_meshes()[item.sub_mesh];
+
+			GL_CHECK_ERROR(glDrawElementsBaseVertex(GL_TRIANGLES, submesh.index_count, GL_UNSIGNED_INT, (void*)(sizeof(uint32_t) * (item.mesh->base_index() + submesh.base_index)), item.mesh->base_vertex() + submesh.base_vertex));
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	uint64_t RenderQueue::make_key(RenderPass pass, Program* program, Mesh* mesh, Material* material, float distance)
+	{
+		uint64_t program_id = id_for(m_program_ids, program);
+		uint64_t material_id = id_for(m_material_ids, material);
+		uint64_t buffer_id = id_for(m_buffer_ids, mesh->mesh_vertex_buffer());
+
+		float t = (distance - m_near) / (m_far - m_near);
+		t = std::min(std::max(t, 0.0f), 1.0f);
+
+		uint64_t key = uint64_t(pass & 0xF) << 60;
+
+		if (pass == RENDER_PASS_TRANSPARENT || pass == RENDER_PASS_OVERLAY)
+		{
+			uint64_t inverted_depth = 0xFFFFFF - uint64_t(t * float(0xFFFFFF));
+
+			key |= inverted_depth << 36;
+			key |= (program_id & 0xFFF) << 24;
+			key |= (material_id & 0xFFF) << 12;
+			key |= (buffer_id & 0xFFF);
+		}
+		else
+		{
+			uint64_t bucket = std::min(uint32_t(t * m_depth_buckets), m_depth_buckets - 1);
+			uint64_t depth = uint64_t(t * float(0xFFFF));
+
+			key |= bucket << 56;
+			key |= (program_id & 0xFFF) << 44;
+			key |= (material_id & 0xFFFF) << 28;
+			key |= (buffer_id & 0xFFF) << 16;
+			key |= depth;
+		}
+
+		return key;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	uint32_t RenderQueue::id_for(std::unordered_map<void*, uint32_t>& ids, void* ptr)
+	{
+		auto itr = ids.find(ptr);
+
+		if (itr != ids.end())
+			return itr->second;
+
+		uint32_t id = ids.size();
+		ids[ptr] = id;
+
+		return id;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+} // namespace dw
@@ -0,0 +1,230 @@
+#include <render_target_pool.h>
+#include <logger.h>
+#include <algorithm>
+
+namespace dw
+{
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	bool RenderTargetDesc::operator==(const RenderTargetDesc& other) const
+	{
+		return width == other.width &&
+			   height == other.height &&
+			   internal_format == other.internal_format &&
+			   format == other.format &&
+			   type == other.type &&
+			   num_samples == other.num_samples &&
+			   array_size == other.array_size &&
+			   mip_levels == other.mip_levels;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	RenderTargetPool::RenderTargetPool(uint32_t max_unused_frames) : m_max_unused_frames(max_unused_frames) {}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	RenderTargetPool::~RenderTargetPool()
+	{
+		clear();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void RenderTargetPool::begin_frame()
+	{
+		m_frame++;
+
+		// Framebuffers go first since they may reference targets that are about to be destroyed.
+		for (size_t i = 0; i < m_framebuffers.size();)
+		{
+			if (m_frame - m_framebuffers[i].last_used_frame > m_max_unused_frames)
+			{
+				m_framebuffers[i] = std::move(m_framebuffers.back());
+				m_framebuffers.pop_back();
+			}
+			else
+				i++;
+		}
+
+		for (size_t i = 0; i < m_targets.size();)
+		{
+			PooledTarget& target = m_targets[i];
+
+			// Targets held across frames, such as history buffers, are never destroyed.
+			if (target.in_use)
+				target.last_used_frame = m_frame;
+
+			if (m_frame - target.last_used_frame > m_max_unused_frames)
+			{
+				GLuint id = target.texture->id();
+
+				for (size_t j = 0; j < m_framebuffers.size();)
+				{
+					auto& attachments = m_framebuffers[j].attachments;
+
+					if (std::find(attachments.begin(), attachments.end(), id) != attachments.end())
+					{
+						m_framebuffers[j] = std::move(m_framebuffers.back());
+						m_framebuffers.pop_back();
+					}
+					else
+						j++;
+				}
+
+				m_targets[i] = std::move(m_targets.back());
+				m_targets.pop_back();
+			}
+			else
+				i++;
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	Texture2D* RenderTargetPool::acquire(const RenderTargetDesc& desc)
+	{
+		for (auto& target : m_targets)
+		{
+			if (!target.in_use && target.desc == desc)
+			{
+				target.in_use = true;
+				target.last_used_frame = m_frame;
+
+				return target.texture.get();
+			}
+		}
+
+		PooledTarget target;
+
+		target.desc = desc;
+		target.texture = std::make_unique<Texture2D>(desc.width, desc.height, desc.array_size, desc.mip_levels, desc.num_samples, desc.internal_format, desc.format, desc.type);
+		target.in_use = true;
+		target.last_used_frame = m_frame;
+
+		if (desc.num_samples == 1)
+		{
+			target.texture->set_min_filter(desc.mip_levels == 1 ? GL_LINEAR : GL_LINEAR_MIPMAP_LINEAR);
+			target.texture->set_wrapping(GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE);
+		}
+
+		m_targets.push_back(std::move(target));
+
+		return m_targets.back().texture.get();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void RenderTargetPool::release(Texture2D* texture)
+	{
+		for (auto& target : m_targets)
+		{
+			if (target.texture.get() == texture)
+			{
+				target.in_use = false;
+				return;
+			}
+		}
+
+		DW_LOG_ERROR("RenderTargetPool: Released render target does not belong to the pool.");
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	Framebuffer* RenderTargetPool::framebuffer(uint32_t color_count, Texture2D** color, Texture2D* depth)
+	{
+		std::vector<GLuint> attachments(color_count + 1);
+
+		for (uint32_t i = 0; i < color_count; i++)
+			attachments[i] = color[i]->id();
+
+		attachments[color_count] = depth ? depth->id() : 0;
+
+		for (auto& entry : m_framebuffers)
+		{
+			if (entry.attachments == attachments)
+			{
+				entry.last_used_frame = m_frame;
+				return entry.fbo.get();
+			}
+		}
+
+		PooledFramebuffer entry;
+
+		entry.attachments = attachments;
+		entry.fbo = std::make_unique<Framebuffer>();
+		entry.last_used_frame = m_frame;
+
+		entry.fbo->set_validation(false);
+
+		if (color_count == 1)
+			entry.fbo->attach_render_target(0, color[0], 0, 0);
+		else if (color_count > 1)
+			entry.fbo->attach_multiple_render_targets(color_count, reinterpret_cast<Texture**>(color));
+
+		if (depth)
+			entry.fbo->attach_depth_stencil_target(depth, 0, 0);
+
+		uint64_t hash = configuration_hash(color_count, color, depth);
+
+		if (m_validated_configurations.find(hash) == m_validated_configurations.end())
+		{
+			// Incomplete framebuffers aren't cached, so the next request with these attachments reports the error again.
+			if (!entry.fbo->validate())
+			{
+				DW_LOG_ERROR("RenderTargetPool: Framebuffer with " + std::to_string(color_count) + " color target(s)" + (depth ? " and a depth target" : "") + " is incomplete.");
+				return nullptr;
+			}
+
+			m_validated_configurations.insert(hash);
+		}
+
+		m_framebuffers.push_back(std::move(entry));
+
+		return m_framebuffers.back().fbo.get();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void RenderTargetPool::clear()
+	{
+		m_framebuffers.clear();
+		m_targets.clear();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	uint64_t RenderTargetPool::configuration_hash(uint32_t color_count, Texture2D** color, Texture2D* depth)
+	{
+		// FNV-1a over the properties that decide completeness. Texture names are left out on purpose so every
+		// framebuffer with the same layout shares one validation.
+		uint64_t hash = 14695981039346656037ull;
+
+		auto combine = [&hash](uint64_t value) {
+			hash ^= value;
+			hash *= 1099511628211ull;
+		};
+
+		combine(color_count);
+
+		for (uint32_t i = 0; i < color_count; i++)
+		{
+			combine(color[i]->internal_format());
+			combine(color[i]->width());
+			combine(color[i]->height());
+			combine(color[i]->num_samples());
+		}
+
+		if (depth)
+		{
+			combine(depth->internal_format());
+			combine(depth->width());
+			combine(depth->height());
+			combine(depth->num_samples());
+		}
+
+		return hash;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+} // namespace dw
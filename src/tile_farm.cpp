@@ -0,0 +1,218 @@
+#include <tile_farm.h>
+#include <logger.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <thread>
+
+namespace dw
+{
+#if !defined(__EMSCRIPTEN__)
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	// Quotes an argument so the shell started by system() passes it through unchanged.
+	static std::string quote(const std::string& arg)
+	{
+#if defined(_WIN32)
+		// Parsed by the C runtime: backslashes are literal unless they precede a quote, where they must be doubled.
+		std::string quoted = "\"";
+		size_t		backslashes = 0;
+
+		for (char c : arg)
+		{
+			if (c == '\\')
+				backslashes++;
+			else
+			{
+				if (c == '"')
+					quoted.append(backslashes + 1, '\\');
+
+				backslashes = 0;
+			}
+
+			quoted += c;
+		}
+
+		quoted.append(backslashes, '\\');
+
+		return quoted + "\"";
+#else
+		// Nothing is special inside single quotes, so only single quotes themselves need escaping.
+		std::string quoted = "'";
+
+		for (char c : arg)
+		{
+			if (c == '\'')
+				quoted += "'\\''";
+			else
+				quoted += c;
+		}
+
+		return quoted + "'";
+#endif
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	// Appends the contents of 'path' starting at 'offset' to 'out' and deletes it.
+	static bool append_part(FILE* out, const std::string& path, long offset)
+	{
+		FILE* part = fopen(path.c_str(), "rb");
+
+		if (!part)
+		{
+			DW_LOG_ERROR("TileFarm: Missing part " + path);
+			return false;
+		}
+
+		fseek(part, offset, SEEK_SET);
+
+		std::vector<char> buffer(1 << 20);
+		size_t			  read = 0;
+
+		while ((read = fread(buffer.data(), 1, buffer.size(), part)) > 0)
+			fwrite(buffer.data(), 1, read, out);
+
+		fclose(part);
+		remove(path.c_str());
+
+		return true;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	bool TileFarm::launch(int argc, const char* argv[], uint32_t worker_count)
+	{
+		std::string command = quote(argv[0]);
+
+		for (int i = 1; i < argc; i++)
+		{
+			// Don't forward the farm option itself or every worker would launch its own farm.
+			if (std::string(argv[i]) == "--farm-workers" && i + 1 < argc)
+				i++;
+			else
+				command += " " + quote(argv[i]);
+		}
+
+		std::vector<std::thread> threads;
+		std::vector<int>		 results(worker_count, 0);
+
+		DW_LOG_INFO("TileFarm: Launching " + std::to_string(worker_count) + " workers");
+
+		// std::system blocks until the worker exits, so each worker is waited on from its own thread.
+		for (uint32_t i = 0; i < worker_count; i++)
+		{
+			std::string worker_command = command + " --headless --farm-worker " + std::to_string(i) + " --farm-workers " + std::to_string(worker_count);
+
+#if defined(_WIN32)
+			// cmd /c strips the first and last quote of a command line containing several quoted arguments.
+			worker_command = "\"" + worker_command + "\"";
+#endif
+
+			threads.push_back(std::thread([&results, i, worker_command]() { results[i] = system(worker_command.c_str()); }));
+		}
+
+		for (auto& thread : threads)
+			thread.join();
+
+		bool success = true;
+
+		for (uint32_t i = 0; i < worker_count; i++)
+		{
+			if (results[i] != 0)
+			{
+				DW_LOG_ERROR("TileFarm: Worker " + std::to_string(i) + " failed with code " + std::to_string(results[i]));
+				success = false;
+			}
+		}
+
+		return success;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void TileFarm::split(uint32_t total, uint32_t worker, uint32_t worker_count, uint32_t& first, uint32_t& count)
+	{
+		first = uint32_t(uint64_t(total) * worker / worker_count);
+		count = uint32_t(uint64_t(total) * (worker + 1) / worker_count) - first;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	std::string TileFarm::part_path(const std::string& path, uint32_t worker)
+	{
+		return path + ".part" + std::to_string(worker);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	bool TileFarm::merge_tiled_capture(const std::string& path, uint32_t width, uint32_t height, uint32_t worker_count)
+	{
+		FILE* out = fopen(path.c_str(), "wb");
+
+		if (!out)
+		{
+			DW_LOG_ERROR("TileFarm: Failed to open " + path);
+			return false;
+		}
+
+		fprintf(out, "P6\n%u %u\n255\n", width, height);
+
+		bool success = true;
+
+		// Parts hold contiguous ranges of strips, so concatenating them in worker order yields the image top to bottom.
+		for (uint32_t i = 0; i < worker_count && success; i++)
+			success = append_part(out, part_path(path, i), 0);
+
+		fclose(out);
+
+		return success;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	bool TileFarm::merge_y4m(const std::string& path, uint32_t worker_count)
+	{
+		FILE* out = fopen(path.c_str(), "wb");
+
+		if (!out)
+		{
+			DW_LOG_ERROR("TileFarm: Failed to open " + path);
+			return false;
+		}
+
+		bool success = true;
+
+		for (uint32_t i = 0; i < worker_count && success; i++)
+		{
+			std::string part = part_path(path, i);
+			long		offset = 0;
+
+			// Every part starts with its own stream header. Only the first one is kept.
+			if (i > 0)
+			{
+				FILE* file = fopen(part.c_str(), "rb");
+
+				if (file)
+				{
+					int c;
+
+					while ((c = fgetc(file)) != EOF && c != '\n')
+						;
+
+					offset = ftell(file);
+					fclose(file);
+				}
+			}
+
+			success = append_part(out, part, offset);
+		}
+
+		fclose(out);
+
+		return success;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+#endif
+} // namespace dw
@@ -0,0 +1,196 @@
+#include <tiled_capture.h>
+#include <framebuffer_readback.h>
+#include <logger.h>
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+
+namespace dw
+{
+#if !defined(__EMSCRIPTEN__)
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	TiledCapture::TiledCapture(uint32_t tile_size) : m_tile_size(tile_size) {}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	TiledCapture::~TiledCapture() {}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	glm::mat4 TiledCapture::tile_projection(const glm::mat4& projection, uint32_t width, uint32_t height, uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1)
+	{
+		// Tile bounds in the NDC of the full image.
+		float left = -1.0f + 2.0f * float(x0) / float(width);
+		float right = -1.0f + 2.0f * float(x1) / float(width);
+		float bottom = -1.0f + 2.0f * float(y0) / float(height);
+		float top = -1.0f + 2.0f * float(y1) / float(height);
+
+		// Scale and offset applied after projection so the tile bounds map to [-1, 1]. Works for any projection since it
+		// only operates on clip space x and y.
+		glm::mat4 crop = glm::mat4(1.0f);
+
+		crop[0][0] = 2.0f / (right - left);
+		crop[1][1] = 2.0f / (top - bottom);
+		crop[3][0] = -(right + left) / (right - left);
+		crop[3][1] = -(top + bottom) / (top - bottom);
+
+		return crop * projection;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	bool TiledCapture::capture(const std::string& path, uint32_t width, uint32_t height, const glm::mat4& projection, RenderCallback render)
+	{
+		if (!create_target())
+			return false;
+
+		FILE* file = fopen(path.c_str(), "wb");
+
+		if (!file)
+		{
+			DW_LOG_ERROR("TiledCapture: Failed to open " + path);
+			return false;
+		}
+
+		fprintf(file, "P6\n%u %u\n255\n", width, height);
+
+		write_strips(file, width, height, projection, render, 0, num_strips(height));
+
+		fclose(file);
+
+		DW_LOG_INFO("TiledCapture: Wrote " + std::to_string(width) + "x" + std::to_string(height) + " image to " + path);
+
+		return true;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	bool TiledCapture::capture_strips(const std::string& path, uint32_t width, uint32_t height, const glm::mat4& projection, RenderCallback render, uint32_t first_strip, uint32_t strip_count)
+	{
+		if (!create_target())
+			return false;
+
+		FILE* file = fopen(path.c_str(), "wb");
+
+		if (!file)
+		{
+			DW_LOG_ERROR("TiledCapture: Failed to open " + path);
+			return false;
+		}
+
+		write_strips(file, width, height, projection, render, first_strip, strip_count);
+
+		fclose(file);
+
+		return true;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	uint32_t TiledCapture::num_strips(uint32_t height)
+	{
+		// The tile size is only final once it has been clamped to the context's limits.
+		if (!create_target())
+			return 0;
+
+		return (height + m_tile_size - 1) / m_tile_size;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void TiledCapture::write_strips(FILE* file, uint32_t width, uint32_t height, const glm::mat4& projection, RenderCallback& render, uint32_t first_strip, uint32_t strip_count)
+	{
+		uint32_t tiles_x = (width + m_tile_size - 1) / m_tile_size;
+		size_t	 row_size = size_t(width) * 3;
+
+		// One strip of tiles, top row first.
+		std::vector<uint8_t> strip(row_size * m_tile_size);
+		FramebufferReadback	 readback;
+
+		// The caller's targets and viewport are restored once all strips are written.
+		GLint last_draw_fbo = 0;
+		GLint last_read_fbo = 0;
+		GLint last_viewport[4];
+
+		GL_CHECK_ERROR(glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &last_draw_fbo));
+		GL_CHECK_ERROR(glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &last_read_fbo));
+		GL_CHECK_ERROR(glGetIntegerv(GL_VIEWPORT, &last_viewport[0]));
+
+		// PPM is stored top to bottom, so strips are rendered from the top of the image down.
+		for (uint32_t ty = first_strip; ty < first_strip + strip_count; ty++)
+		{
+			uint32_t top = height - ty * m_tile_size;
+			uint32_t bottom = top > m_tile_size ? top - m_tile_size : 0;
+			uint32_t tile_h = top - bottom;
+
+			for (uint32_t tx = 0; tx < tiles_x; tx++)
+			{
+				uint32_t left = tx * m_tile_size;
+				uint32_t right = std::min(left + m_tile_size, width);
+				uint32_t tile_w = right - left;
+
+				glm::mat4 tile_proj = tile_projection(projection, width, height, left, bottom, right, top);
+
+				m_fbo->bind();
+				GL_CHECK_ERROR(glViewport(0, 0, tile_w, tile_h));
+
+				render(m_fbo.get(), tile_proj, tile_w, tile_h);
+
+				// The readback of this tile overlaps rendering of the next one in the same target; GL orders the two.
+				readback.read(m_fbo.get(), 0, 0, 0, tile_w, tile_h, [&strip, row_size, left](const void* pixels, uint32_t w, uint32_t h, uint64_t) {
+					const uint8_t* src = static_cast<const uint8_t*>(pixels);
+
+					for (uint32_t y = 0; y < h; y++)
+						memcpy(&strip[(h - 1 - y) * row_size + size_t(left) * 3], src + size_t(y) * w * 3, size_t(w) * 3);
+				}, GL_RGB, GL_UNSIGNED_BYTE);
+
+				readback.poll();
+			}
+
+			readback.flush();
+
+			fwrite(strip.data(), 1, row_size * tile_h, file);
+		}
+
+		GL_CHECK_ERROR(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, last_draw_fbo));
+		GL_CHECK_ERROR(glBindFramebuffer(GL_READ_FRAMEBUFFER, last_read_fbo));
+		GL_CHECK_ERROR(glViewport(last_viewport[0], last_viewport[1], last_viewport[2], last_viewport[3]));
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	bool TiledCapture::create_target()
+	{
+		if (m_fbo)
+			return true;
+
+		GLint max_texture_size = 0;
+		GLint max_viewport[2] = { 0, 0 };
+
+		GL_CHECK_ERROR(glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size));
+		GL_CHECK_ERROR(glGetIntegerv(GL_MAX_VIEWPORT_DIMS, &max_viewport[0]));
+
+		m_tile_size = std::min(m_tile_size, uint32_t(std::min(max_texture_size, std::min(max_viewport[0], max_viewport[1]))));
+
+		m_color = std::make_unique<Texture2D>(m_tile_size, m_tile_size, 1, 1, 1, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+		m_depth = std::make_unique<Texture2D>(m_tile_size, m_tile_size, 1, 1, 1, GL_DEPTH_COMPONENT32F, GL_DEPTH_COMPONENT, GL_FLOAT);
+		m_fbo = std::make_unique<Framebuffer>();
+
+		m_fbo->set_validation(false);
+		m_fbo->attach_render_target(0, m_color.get(), 0, 0);
+		m_fbo->attach_depth_stencil_target(m_depth.get(), 0, 0);
+
+		if (!m_fbo->validate())
+		{
+			DW_LOG_ERROR("TiledCapture: Failed to create tile render target.");
+			m_fbo.reset();
+			return false;
+		}
+
+		return true;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+#endif
+} // namespace dw
@@ -0,0 +1,112 @@
+#include <vertex_pulling.h>
+#include <mesh.h>
+#include <logger.h>
+
+namespace dw
+{
+#if !defined(__EMSCRIPTEN__)
+	// Vertex is tightly packed as 14 floats. vec3 members would be padded to 16 bytes in std430, so the data is read as
+	// a flat float array instead.
+	static const std::string kVertexPullingSource = R"(
+layout(std430, binding = )" + std::to_string(VERTEX_PULLING_VERTEX_BINDING) + R"() readonly buffer MeshVertices
+{
+	float u_Vertices[];
+};
+
+layout(std430, binding = )" + std::to_string(VERTEX_PULLING_INDEX_BINDING) + R"() readonly buffer MeshIndices
+{
+	uint u_Indices[];
+};
+
+layout(location = )" + std::to_string(VERTEX_PULLING_BASE_VERTEX_LOCATION) + R"() uniform int u_BaseVertex;
+
+struct PulledVertex
+{
+	vec3 position;
+	vec2 tex_coord;
+	vec3 normal;
+	vec3 tangent;
+	vec3 bitangent;
+};
+
+PulledVertex pull_vertex()
+{
+	uint base = (u_Indices[gl_VertexID] + uint(u_BaseVertex)) * 14u;
+
+	PulledVertex v;
+
+	v.position = vec3(u_Vertices[base], u_Vertices[base + 1u], u_Vertices[base + 2u]);
+	v.tex_coord = vec2(u_Vertices[base + 3u], u_Vertices[base + 4u]);
+	v.normal = vec3(u_Vertices[base + 5u], u_Vertices[base + 6u], u_Vertices[base + 7u]);
+	v.tangent = vec3(u_Vertices[base + 8u], u_Vertices[base + 9u], u_Vertices[base + 10u]);
+	v.bitangent = vec3(u_Vertices[base + 11u], u_Vertices[base + 12u], u_Vertices[base + 13u]);
+
+	return v;
+}
+)";
+
+	static_assert(sizeof(Vertex) == sizeof(float) * 14, "pull_vertex() assumes a tightly packed Vertex.");
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	bool VertexPulling::supported()
+	{
+		return GLAD_GL_VERSION_4_3 != 0;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	const std::string& VertexPulling::glsl_source()
+	{
+		return kVertexPullingSource;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	VertexPulling::VertexPulling()
+	{
+		if (!supported())
+			DW_LOG_ERROR("OPENGL: Vertex pulling requires Shader Storage Buffers (OpenGL 4.3).");
+
+		GL_CHECK_ERROR(glGenVertexArrays(1, &m_gl_vao));
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	VertexPulling::~VertexPulling()
+	{
+		glDeleteVertexArrays(1, &m_gl_vao);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void VertexPulling::bind()
+	{
+		GL_CHECK_ERROR(glBindVertexArray(m_gl_vao));
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void VertexPulling::bind_mesh(Mesh* mesh)
+	{
+		// Buffer objects are not tied to their creation target, so the existing buffers are bound as storage directly.
+		GL_CHECK_ERROR(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VERTEX_PULLING_VERTEX_BINDING, mesh->mesh_vertex_buffer()->id()));
+		GL_CHECK_ERROR(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VERTEX_PULLING_INDEX_BINDING, mesh->mesh_index_buffer()->id()));
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void VertexPulling::draw(Mesh* mesh, uint32_t sub_mesh)
+	{
+		SubMesh& submesh = mesh->sub_meshes()[sub_mesh];
+
+		// Fixed location, so no lookup is needed per draw.
+		GL_CHECK_ERROR(glUniform1i(VERTEX_PULLING_BASE_VERTEX_LOCATION, int(mesh->base_vertex() + submesh.base_vertex)));
+
+		// gl_VertexID starts at 'first', so it directly indexes the SubMesh's indices.
+		GL_CHECK_ERROR(glDrawArrays(GL_TRIANGLES, mesh->base_index() + submesh.base_index, submesh.index_count));
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+#endif
+} // namespace dw
@@ -0,0 +1,90 @@
+#include <worker_pool.h>
+
+namespace dw
+{
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	WorkerPool& WorkerPool::get()
+	{
+		static WorkerPool pool;
+		return pool;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	WorkerPool::WorkerPool() {}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	WorkerPool::~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+
+		m_wake.notify_all();
+
+		for (auto& thread : m_threads)
+			thread.join();
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void WorkerPool::run(uint32_t count, const std::function<void(uint32_t)>& job)
+	{
+		if (count == 0)
+			return;
+
+		std::lock_guard<std::mutex> run_lock(m_run_mutex);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			while (m_threads.size() < count - 1)
+				m_threads.push_back(std::thread(&WorkerPool::worker, this));
+
+			m_job = &job;
+			m_next = 1;
+			m_count = count;
+			m_pending = count - 1;
+		}
+
+		m_wake.notify_all();
+
+		job(0);
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_done.wait(lock, [this]() { return m_pending == 0; });
+
+		m_job = nullptr;
+		m_count = 0;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+
+	void WorkerPool::worker()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		while (true)
+		{
+			m_wake.wait(lock, [this]() { return m_stop || m_next < m_count; });
+
+			if (m_stop)
+				return;
+
+			uint32_t index = m_next++;
+			const std::function<void(uint32_t)>& job = *m_job;
+
+			lock.unlock();
+			job(index);
+			lock.lock();
+
+			if (--m_pending == 0)
+				m_done.notify_all();
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------------
+} // namespace dw